@@ -1,9 +1,22 @@
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+
 #include "glog/logging.h"
+#include "page/b_plus_tree_page.h"
 #include "page/bitmap_page.h"
 
 static const char EMPTY_PAGE_DATA[PAGE_SIZE] = {0};
+// ClassifyPage()所依据的页面布局
+static constexpr uint32_t METADATA_MAGIC_NUM = 344528;  // TableMetadata和IndexMetadata序列化的开头
+static constexpr size_t BPLUS_TREE_PAGE_TYPE_OFFSET = 0;  // BPlusTreePage::page_type_
+static constexpr size_t BPLUS_TREE_PAGE_ID_OFFSET = 24;   // BPlusTreePage::page_id_
+static constexpr size_t TABLE_PAGE_ID_OFFSET = 0;         // TablePage开头的page id
 //这一部分的代码是实现BufferPoolManager的功能
 //BufferPoolManager的功能是管理buffer pool，即缓冲池
 //缓冲池是内存中的一块区域，用于存放磁盘中的数据
@@ -14,20 +27,62 @@ static const char EMPTY_PAGE_DATA[PAGE_SIZE] = {0};
 //缓冲池中的每一页都有一个is_dirty，表示这一页是否被修改过
 //缓冲池中的每一页都有一个data_，表示这一页的数据
 //缓冲池中的每一页都有一个page_table_，表示这一页在缓冲池中的位置
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager) {
-  pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size_);
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, ReplacerType replacer_type,
+                                     size_t max_pool_size)
+    : read_only_(disk_manager->IsReadOnly()),
+      pool_size_(read_only_ ? 0 : pool_size),
+      max_pool_size_(read_only_ ? 0 : std::max(pool_size, max_pool_size)),
+      frames_(pool_size_, max_pool_size_),
+      pages_(AllocateDescriptors(max_pool_size_)),
+      disk_manager_(disk_manager),
+      page_table_(max_pool_size_),
+      ring_owner_(max_pool_size_, nullptr),
+      reading_(new atomic<bool>[max_pool_size_]) {
+  //按容量分配page table等结构，扩容时不需要重建；描述符只构造当前用到的部分
+  ConstructDescriptors(pages_, 0, pool_size_, frames_.GetData());
+  num_constructed_ = pool_size_;
+  //直接I/O时帧直接作为读写的缓冲区，不经过中转
+  ASSERT(!disk_manager_->IsDirectIO() || DiskManager::IsAligned(frames_.GetData()), "Frames are not aligned.");
+  switch (replacer_type) {
+    case ReplacerType::kClock:
+      replacer_ = new CLOCKReplacer(pool_size_);
+      break;
+    case ReplacerType::kLRUK:
+      replacer_ = new LRUKReplacer(pool_size_);
+      break;
+    case ReplacerType::kLRU:
+    default:
+      replacer_ = new LRUReplacer(pool_size_);
+      break;
+  }
   for (size_t i = 0; i < pool_size_; i++) {
     free_list_.emplace_back(i);
   }
+  for (size_t i = 0; i < max_pool_size_; i++) {
+    reading_[i] = false;
+  }
 }
 
+BufferPoolManager::BufferPoolManager(DiskManager *disk_manager)
+    : read_only_(disk_manager->IsReadOnly()),
+      pool_size_(0),
+      max_pool_size_(0),
+      frames_(0),
+      pages_(nullptr),
+      disk_manager_(disk_manager),
+      page_table_(0),
+      replacer_(nullptr) {}
+
 BufferPoolManager::~BufferPoolManager() {
-  for (auto page : page_table_) {
-    FlushPage(page.first);
+  StopPrefetcher();
+  StopBackgroundWriter();
+  page_table_.ForEach([this](page_id_t page_id, frame_id_t frame_id) {
+    disk_manager_->WritePage(page_id, pages_[frame_id].data_);
+  });
+  DeleteDescriptors(pages_, num_constructed_);
+  for (auto chunk : mapped_pages_) {
+    DeleteDescriptors(chunk, chunk == nullptr ? 0 : MAPPED_PAGES_PER_CHUNK);
   }
-  delete[] pages_;
   delete replacer_;
 }
 
@@ -38,43 +93,47 @@ BufferPoolManager::~BufferPoolManager() {
 // 2.     If R is dirty, write it back to the disk.
 // 3.     Delete R from the page table and insert P.
 // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-Page *BufferPoolManager::FetchPage(page_id_t page_id) {
+Page *BufferPoolManager::FetchPage(page_id_t page_id) { return FetchPage(page_id, nullptr); }
+
+Page *BufferPoolManager::FetchPage(page_id_t page_id, BufferRing *ring) {
+  ASSERT(ring == nullptr || ring->bpm_ == this, "Buffer ring belongs to another buffer pool.");
   //page_id判断
-  // return nullptr;
   if(page_id > MAX_VALID_PAGE_ID || page_id <= INVALID_PAGE_ID) return nullptr;
-  //latch_.lock();
+  RecordAccess(page_id);
+  if(read_only_) return FetchMappedPage(page_id);//只读映射，不拷贝
+  Page *pinned = TryPinPinnedPage(page_id);//别人正pin着该页时不必拿latch
+  if(pinned != nullptr) return pinned;
+  std::unique_lock<std::recursive_mutex> lock = LockForPin();
   //若在page_table中找到了page_id
-  if(page_table_.count(page_id)!=0){
-    frame_id_t tmp = page_table_[page_id];//找到了page_id
+  frame_id_t tmp;
+  if(page_table_.Find(page_id, tmp)){//找到了page_id
     pages_[tmp].pin_count_++;//pin++
-    replacer_->Pin(tmp);//
-    //latch_.unlock();
+    TouchPage(pages_[tmp]);
+    if(ring_owner_[tmp] == nullptr) replacer_->Pin(tmp);//ring中的frame不进入replacer
+    if(reading_[tmp]){//预读线程正在读该页，已经pin住，释放latch等它读完
+      lock.unlock();
+      WaitForRead(tmp);
+    }
+    CountersOf(pages_[tmp]).hits++;
     return &pages_[tmp];
   }
   //若在page_table中没有找到page_id
-  frame_id_t tmp;
-  if(free_list_.size()<=0)//free_list为空
-  {
-    if(replacer_->Victim(&tmp)==false) return nullptr;//replacer也没有
-    if(pages_[tmp].IsDirty())//dirty
-    {
-      disk_manager_->WritePage(pages_[tmp].GetPageId(),pages_[tmp].GetData());
-    }
-    //page_table_.erase(pages_[tmp].page_id_);//删除page_id
+  bool found = ring != nullptr ? TryToFindRingFrame(ring, tmp) : TryToFindFreeFrame(tmp);
+  if(!found){//free_list和replacer都没有
+    failed_victim_searches_++;
+    return nullptr;
   }
-  else//free_list不为空
-  {
-    tmp = free_list_.front();//取出free_list的第一个
-    free_list_.pop_front();//删除第一个
-  }
-  page_table_[page_id] = tmp;//插入page_table
+  page_table_.Insert(page_id, tmp);//插入page_table
+  if(ring == nullptr) replacer_->Pin(tmp);//记录一次访问，LRU-K需要
   //Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  pages_[tmp].pin_count_ = 1;
   pages_[tmp].page_id_ = page_id;
-  
+  pages_[tmp].is_dirty_ = false;
+  TouchPage(pages_[tmp]);
+  WaitForBackgroundWrite(page_id);//后台写线程正在写该页时，等它写完再读
   disk_manager_->ReadPage(page_id, pages_[tmp].data_);
-  //latch_.unlock();
-  // return nullptr;
+  pages_[tmp].kind_ = ClassifyPage(page_id, pages_[tmp].data_);
+  pages_[tmp].pin_count_ = 1;//最后发布pin，不拿latch的FetchPage只pin读完的页
+  CountersOf(pages_[tmp]).misses++;
   return &pages_[tmp];
 }
 
@@ -84,52 +143,106 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
 // 3.   Update P's metadata, zero out memory and add P to the page table.
 // 4.   Set the page ID output parameter. Return a pointer to P.
 Page *BufferPoolManager::NewPage(page_id_t &page_id) {
-  if(free_list_.size()>0)//在free_list中存在
-  {
-    frame_id_t tmp = free_list_.front();
-    free_list_.pop_front();
-    page_id = AllocatePage();
-    page_table_[page_id] = tmp;
-    pages_[tmp].page_id_ = page_id;
-    pages_[tmp].pin_count_ = 1;
-    pages_[tmp].is_dirty_ = false;
-    memset(pages_[tmp].data_,0,PAGE_SIZE);
-    return &pages_[tmp];
-  }
-  //从replacer中找
-  frame_id_t tmp ;//找到的frame_id
-  if(replacer_->Victim(&tmp)==false) return nullptr;//replacer也没有
-  if(pages_[tmp].IsDirty())//dirty
-  {
-    disk_manager_->WritePage(pages_[tmp].GetPageId(),pages_[tmp].GetData());//写回磁盘
+  std::unique_lock<std::recursive_mutex> lock = LockForPin();
+  frame_id_t tmp;//找到的frame_id
+  if(!TryToFindFreeFrame(tmp)){//free_list和replacer都没有
+    failed_victim_searches_++;
+    return nullptr;
   }
   page_id = AllocatePage();//分配新页面
-  page_table_[page_id] = tmp;//插入page_table
-  page_table_.erase(pages_[tmp].page_id_);//删除page_id,因为已经分配了新的page_id
-  //Update P's metadata, read in the page content from disk, and then return a pointer to P.
+  if(page_id == INVALID_PAGE_ID){//磁盘已满，归还frame
+    free_list_.push_back(tmp);
+    return nullptr;
+  }
+  page_table_.Insert(page_id, tmp);//插入page_table
+  replacer_->Pin(tmp);
   pages_[tmp].ResetMemory();
   pages_[tmp].page_id_ = page_id;
+  pages_[tmp].is_dirty_ = false;
+  pages_[tmp].kind_ = ClassifyPage(page_id, pages_[tmp].data_);//还没有初始化，unpin时再判断
+  TouchPage(pages_[tmp]);
   pages_[tmp].pin_count_ = 1;
+  return &pages_[tmp];
+}
+
+std::vector<Page *> BufferPoolManager::NewPages(size_t num_pages) {
+  std::vector<Page *> pages;
+  //已经创建的页取消pin并删除，删除时会释放page_id
+  auto undo = [this, &pages] {
+    for (auto page : pages) {
+      page_id_t page_id = page->GetPageId();
+      UnpinPage(page_id, false);
+      DeletePage(page_id);
+    }
+    return std::vector<Page *>();
+  };
+  page_id_t first_page_id = num_pages > 1 ? AllocatePages(num_pages) : INVALID_PAGE_ID;
+  if (first_page_id == INVALID_PAGE_ID) {
+    //没有足够长的连续空闲页，逐页分配
+    for (size_t i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      Page *page = NewPage(page_id);
+      if (page == nullptr) return undo();
+      pages.push_back(page);
+    }
+    return pages;
+  }
+  for (size_t i = 0; i < num_pages; i++) {
+    Page *page = NewPageWithId(first_page_id + i);
+    if (page == nullptr) {
+      for (size_t j = i; j < num_pages; j++) {
+        DeallocatePage(first_page_id + j);
+      }
+      return undo();
+    }
+    pages.push_back(page);
+  }
+  return pages;
+}
+
+Page *BufferPoolManager::NewPageWithId(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  frame_id_t tmp;
+  if(!TryToFindFreeFrame(tmp)){
+    failed_victim_searches_++;
+    return nullptr;
+  }
+  page_table_.Insert(page_id, tmp);
+  replacer_->Pin(tmp);
+  pages_[tmp].ResetMemory();
+  pages_[tmp].page_id_ = page_id;
   pages_[tmp].is_dirty_ = false;
+  pages_[tmp].kind_ = ClassifyPage(page_id, pages_[tmp].data_);//还没有初始化，unpin时再判断
+  TouchPage(pages_[tmp]);
+  pages_[tmp].pin_count_ = 1;
   return &pages_[tmp];
 }
+
 // 0.   Make sure you call DeallocatePage!
 // 1.   Search the page table for the requested page (P).
 // 1.   If P does not exist, return true.
 // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
 // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
-  if(page_table_.count(page_id)==0) return true;//不存在
-  frame_id_t tmp = page_table_[page_id];//找到了page_id
+  if(read_only_) return false;
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  frame_id_t tmp;
+  if(!page_table_.Find(page_id, tmp)) return true;//不存在
 
   if(pages_[tmp].pin_count_>0) return false;//pin_count>0
-  page_table_.erase(page_id);//从page_table中删除，因为page_table用于跟踪页面的元数据
+  page_table_.Erase(page_id);//从page_table中删除，因为page_table用于跟踪页面的元数据
+  replacer_->Remove(tmp);//从replacer中移除，避免被再次选为victim
+  ring_owner_[tmp] = nullptr;
   pages_[tmp].page_id_=INVALID_PAGE_ID;
+  pages_[tmp].is_dirty_ = false;
   pages_[tmp].ResetMemory();//重置metadata
-  free_list_.push_back(tmp);//把tmp放回free_list，因为删除了，已经是空闲的了
+  if(static_cast<size_t>(tmp) < pool_size_){
+    free_list_.push_back(tmp);//把tmp放回free_list，因为删除了，已经是空闲的了
+  }else{
+    frames_.Release(tmp, 1);//缩容后留下的帧，不再回到缓冲池
+  }
   DeallocatePage(page_id);//释放page_id
   return true;
- 
 }
 //实现思路：
 //1.首先判断page_id是否在page_table中，如果不在则返回false
@@ -143,11 +256,24 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
 //frame和page的区别在于frame是缓冲池中的一个页面，page是磁盘中的一个页面
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) //取消页面的引用，若is_dirty为true，则表示页面被修改过，需要写回磁盘
 {
-  if(page_table_.count(page_id)==0) return false;//不在page_table中,无法unpin
-  frame_id_t tmp = page_table_[page_id];//找到了page_id
-  pages_[tmp].pin_count_--;//pin_count--
-  if(pages_[tmp].pin_count_==0) replacer_->Unpin(tmp);//pin_count为0，插入replacer_
-  if(is_dirty) pages_[tmp].is_dirty_ = true;//dirty
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  if(read_only_){//只读映射的页不会变脏
+    Page *page = FindMappedPage(page_id);
+    if(page == nullptr || page->pin_count_ <= 0) return false;
+    page->pin_count_--;
+    return !is_dirty;//照样unpin，但不能当作写回成功
+  }
+  frame_id_t tmp;
+  if(!page_table_.Find(page_id, tmp)) return false;//不在page_table中,无法unpin
+  if(pages_[tmp].pin_count_ <= 0) return false;//没有被pin住
+  if(is_dirty){//dirty，内容可能变了，重新判断页的种类
+    pages_[tmp].is_dirty_ = true;
+    pages_[tmp].kind_ = ClassifyPage(page_id, pages_[tmp].data_);
+  }
+  if(--pages_[tmp].pin_count_ == 0){//pin_count--
+    if(static_cast<size_t>(tmp) >= pool_size_) RetireFrame(tmp);//缩容时仍被pin住的帧，最后一次unpin时退出缓冲池
+    else if(ring_owner_[tmp] == nullptr) replacer_->Unpin(tmp);//pin_count为0，插入replacer_
+  }
   return true;
 }
 //实现思路：
@@ -157,15 +283,546 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) //取消页
 //4.返回true
 //flush_page的作用是将缓冲池中的页面刷新到磁盘上
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
-  latch_.lock();//加锁,因为要修改page_table_，如果没有加锁，可能会出现多线程访问的问题
-  frame_id_t tmp = page_table_[page_id];
-  if(page_table_.count(page_id)>0){
-    disk_manager_->WritePage(page_id, pages_[tmp].data_);
-    latch_.unlock();
+  if(read_only_) return true;//只读映射，没有要写回的内容
+  std::scoped_lock<std::recursive_mutex> lock(latch_);//加锁,因为要访问page_table_
+  frame_id_t tmp;
+  if(!page_table_.Find(page_id, tmp)) return false;
+  if(reading_[tmp]) return true;//正在预读，内容与磁盘一致
+  WaitForBackgroundWrite(page_id);
+  disk_manager_->WritePage(page_id, pages_[tmp].data_);
+  if(pages_[tmp].is_dirty_) CountersOf(pages_[tmp]).dirty_writebacks++;
+  pages_[tmp].is_dirty_ = false;
+  return true;
+}
+
+bool BufferPoolManager::TryToFindFreeFrame(frame_id_t &frame_id) {
+  if(!free_list_.empty()){//free_list不为空，取出第一个
+    frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  if(!replacer_->Victim(&frame_id)) return false;//replacer也没有
+  evictions_++;
+  Page &victim = pages_[frame_id];
+  CountersOf(victim).evictions++;
+  if(victim.IsDirty()){//dirty，写回磁盘，后台写线程没能提前写回
+    fg_victim_writes_++;
+    CountersOf(victim).dirty_writebacks++;
+    WakeBackgroundWriter();
+    WaitForBackgroundWrite(victim.GetPageId());
+    disk_manager_->WritePage(victim.GetPageId(), victim.GetData());
+    victim.is_dirty_ = false;
+  }
+  page_table_.Erase(victim.page_id_);//删除旧的page_id
+  return true;
+}
+
+bool BufferPoolManager::TryToFindRingFrame(BufferRing *ring, frame_id_t &frame_id) {
+  if (ring->frames_.size() < ring->ring_size_ && TryToFindFreeFrame(frame_id)) {
+    // the ring is still growing
+    ring_owner_[frame_id] = ring;
+    ring->frames_.push_back(frame_id);
     return true;
   }
-  latch_.unlock();
-  return false;
+  if (ring->frames_.empty()) return false;
+  size_t slot = ring->next_;
+  ring->next_ = (ring->next_ + 1) % ring->frames_.size();
+  frame_id_t candidate = ring->frames_[slot];
+  if (ring_owner_[candidate] == ring && pages_[candidate].pin_count_ == 0) {
+    Page &old = pages_[candidate];
+    evictions_++;
+    CountersOf(old).evictions++;
+    if (old.IsDirty()) {
+      fg_victim_writes_++;
+      CountersOf(old).dirty_writebacks++;
+      WakeBackgroundWriter();
+      WaitForBackgroundWrite(old.GetPageId());
+      disk_manager_->WritePage(old.GetPageId(), old.GetData());
+      old.is_dirty_ = false;
+    }
+    page_table_.Erase(old.page_id_);
+    frame_id = candidate;
+    return true;
+  }
+  // the frame is still in use or was deleted meanwhile, replace it by another one
+  if (ring_owner_[candidate] == ring) {
+    ring_owner_[candidate] = nullptr;  // enters the main replacer once it is unpinned
+  }
+  if (!TryToFindFreeFrame(frame_id)) return false;
+  ring_owner_[frame_id] = ring;
+  ring->frames_[slot] = frame_id;
+  return true;
+}
+
+bool BufferPoolManager::Resize(size_t pool_size) {
+  if (read_only_ || pool_size == 0 || pool_size > max_pool_size_) return false;
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  size_t old_size = pool_size_;
+  if (pool_size >= old_size) {
+    if (pool_size > num_constructed_) {
+      ConstructDescriptors(pages_, num_constructed_, pool_size, frames_.GetData());
+      num_constructed_ = pool_size;
+    }
+    replacer_->SetCapacity(pool_size);
+    for (size_t i = old_size; i < pool_size; i++) {
+      // a frame still pinned since an earlier shrink simply stays in the pool
+      if (pages_[i].page_id_ == INVALID_PAGE_ID) free_list_.push_back(i);
+    }
+    pool_size_ = pool_size;
+    return true;
+  }
+  // unpinning a frame beyond pool_size_ retires it from now on
+  pool_size_ = pool_size;
+  free_list_.remove_if([pool_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= pool_size; });
+  for (size_t i = pool_size; i < old_size; i++) {
+    ring_owner_[i] = nullptr;  // the ring replaces the frame when it comes back to its slot
+    if (pages_[i].page_id_ != INVALID_PAGE_ID && pages_[i].pin_count_ == 0) {
+      RetireFrame(i);
+    } else if (pages_[i].page_id_ == INVALID_PAGE_ID) {
+      frames_.Release(i, 1);
+    }
+  }
+  replacer_->SetCapacity(pool_size);
+  return true;
+}
+
+void BufferPoolManager::RetireFrame(frame_id_t frame_id) {
+  Page &page = pages_[frame_id];
+  replacer_->Remove(frame_id);
+  evictions_++;
+  CountersOf(page).evictions++;
+  if (page.is_dirty_) {
+    CountersOf(page).dirty_writebacks++;
+    WaitForBackgroundWrite(page.page_id_);
+    disk_manager_->WritePage(page.page_id_, page.data_);
+  }
+  page_table_.Erase(page.page_id_);
+  page.page_id_ = INVALID_PAGE_ID;
+  page.is_dirty_ = false;
+  page.kind_ = PageKind::kOther;
+  frames_.Release(frame_id, 1);
+}
+
+std::unique_ptr<BufferRing> BufferPoolManager::NewBufferRing(size_t ring_size) {
+  ASSERT(ring_size > 0, "A buffer ring needs at least one frame.");
+  return std::unique_ptr<BufferRing>(new BufferRing(this, ring_size));
+}
+
+void BufferPoolManager::ReleaseBufferRing(BufferRing *ring) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  for (auto frame_id : ring->frames_) {
+    if (ring_owner_[frame_id] != ring) {
+      continue;
+    }
+    ring_owner_[frame_id] = nullptr;
+    if (pages_[frame_id].pin_count_ == 0) {
+      replacer_->Unpin(frame_id);
+    }
+  }
+  ring->frames_.clear();
+}
+
+void BufferPoolManager::StartBackgroundWriter(double clean_ratio) {
+  std::scoped_lock<std::mutex> lock(bg_writer_latch_);
+  // a read-only pool never has anything to write
+  if (bg_writer_running_ || read_only_) return;
+  bg_writer_running_ = true;
+  bg_writer_ = std::thread(&BufferPoolManager::BackgroundWriterLoop, this, clean_ratio);
+}
+
+void BufferPoolManager::StopBackgroundWriter() {
+  {
+    std::scoped_lock<std::mutex> lock(bg_writer_latch_);
+    if (!bg_writer_running_) return;
+    bg_writer_running_ = false;
+  }
+  bg_writer_cv_.notify_all();
+  bg_writer_.join();
+}
+
+BufferWriterStats BufferPoolManager::GetWriterStats() {
+  BufferWriterStats stats;
+  stats.bg_pages_written = bg_pages_written_;
+  stats.bg_writes = bg_writes_;
+  stats.evictions = evictions_;
+  stats.fg_victim_writes = fg_victim_writes_;
+  stats.fg_write_waits = fg_write_waits_;
+  return stats;
+}
+
+BufferPoolStats BufferPoolManager::GetBufferStats() {
+  BufferPoolStats stats;
+  for (size_t i = 0; i < NUM_PAGE_KINDS; i++) {
+    stats.kinds[i].hits = kind_counters_[i].hits;
+    stats.kinds[i].misses = kind_counters_[i].misses;
+    stats.kinds[i].evictions = kind_counters_[i].evictions;
+    stats.kinds[i].dirty_writebacks = kind_counters_[i].dirty_writebacks;
+  }
+  stats.failed_victim_searches = failed_victim_searches_;
+  stats.pin_waits = pin_waits_;
+  stats.pin_wait_ns = pin_wait_ns_;
+  return stats;
+}
+
+BufferKindStats BufferPoolStats::Total() const {
+  BufferKindStats total;
+  for (const auto &kind : kinds) {
+    total.hits += kind.hits;
+    total.misses += kind.misses;
+    total.evictions += kind.evictions;
+    total.dirty_writebacks += kind.dirty_writebacks;
+  }
+  return total;
+}
+
+void BufferPoolStats::Merge(const BufferPoolStats &other) {
+  for (size_t i = 0; i < NUM_PAGE_KINDS; i++) {
+    kinds[i].hits += other.kinds[i].hits;
+    kinds[i].misses += other.kinds[i].misses;
+    kinds[i].evictions += other.kinds[i].evictions;
+    kinds[i].dirty_writebacks += other.kinds[i].dirty_writebacks;
+  }
+  failed_victim_searches += other.failed_victim_searches;
+  pin_waits += other.pin_waits;
+  pin_wait_ns += other.pin_wait_ns;
+}
+
+PageKind BufferPoolManager::ClassifyPage(page_id_t page_id, const char *data) {
+  if (page_id == CATALOG_META_PAGE_ID || page_id == INDEX_ROOTS_PAGE_ID) return PageKind::kCatalog;
+  auto read_int = [data](size_t offset) {
+    int32_t value;
+    memcpy(&value, data + offset, sizeof(value));
+    return value;
+  };
+  int32_t page_type = read_int(BPLUS_TREE_PAGE_TYPE_OFFSET);
+  if (read_int(BPLUS_TREE_PAGE_ID_OFFSET) == page_id) {
+    if (page_type == static_cast<int32_t>(IndexPageType::LEAF_PAGE)) return PageKind::kIndexLeaf;
+    if (page_type == static_cast<int32_t>(IndexPageType::INTERNAL_PAGE)) return PageKind::kIndexInternal;
+  }
+  if (read_int(TABLE_PAGE_ID_OFFSET) == page_id) return PageKind::kTable;
+  if (static_cast<uint32_t>(read_int(0)) == METADATA_MAGIC_NUM) return PageKind::kCatalog;
+  return PageKind::kOther;
+}
+
+std::unique_lock<std::recursive_mutex> BufferPoolManager::LockForPin() {
+  std::unique_lock<std::recursive_mutex> lock(latch_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    auto start = std::chrono::steady_clock::now();
+    lock.lock();
+    RecordPinWait(start);
+  }
+  return lock;
+}
+
+void BufferPoolManager::RecordPinWait(std::chrono::steady_clock::time_point start) {
+  auto waited = std::chrono::steady_clock::now() - start;
+  pin_waits_++;
+  pin_wait_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count();
+}
+
+void BufferPoolManager::BackgroundWriterLoop(double clean_ratio) {
+  // 与frame一样对齐，direct I/O下批量写不必经过bounce buffer
+  FrameArena staging(BG_WRITER_MAX_PAGES);
+  std::vector<DirtyPage> dirty_pages;
+  std::vector<std::pair<page_id_t, const char *>> writes;
+  std::unique_lock<std::mutex> lock(bg_writer_latch_);
+  while (bg_writer_running_) {
+    lock.unlock();
+    dirty_pages.clear();
+    CollectDirtyPages(clean_ratio, staging.GetData(), BG_WRITER_MAX_PAGES, dirty_pages);
+    if (!dirty_pages.empty()) {
+      writes.clear();
+      for (auto &dirty_page : dirty_pages) {
+        writes.emplace_back(dirty_page.page_id, dirty_page.data);
+      }
+      bg_writes_ += disk_manager_->WritePages(writes);
+      bg_pages_written_ += dirty_pages.size();
+      for (auto &dirty_page : dirty_pages) {
+        dirty_page.owner->FinishBackgroundWrite(dirty_page.page_id);
+      }
+    }
+    lock.lock();
+    // a full round means there is more to write, otherwise wait for new dirty pages
+    if (dirty_pages.size() < BG_WRITER_MAX_PAGES) {
+      bg_writer_cv_.wait_for(lock, std::chrono::milliseconds(BG_WRITER_INTERVAL_MS),
+                             [this] { return !bg_writer_running_ || bg_writer_wakeup_; });
+    }
+    bg_writer_wakeup_ = false;
+  }
+}
+
+size_t BufferPoolManager::CollectDirtyPages(double clean_ratio, char *staging, size_t max_pages,
+                                            vector<DirtyPage> &dirty_pages) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  size_t target = static_cast<size_t>(std::ceil(clean_ratio * pool_size_));
+  size_t clean = 0;
+  std::vector<frame_id_t> candidates;
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (pages_[i].page_id_ == INVALID_PAGE_ID || !pages_[i].is_dirty_) {
+      clean++;
+    } else if (pages_[i].pin_count_ == 0) {
+      candidates.push_back(i);
+    }
+  }
+  if (clean >= target) return 0;
+  size_t collected = 0;
+  std::scoped_lock<std::mutex> io_lock(io_latch_);
+  for (size_t i = 0; i < candidates.size() && clean + collected < target && dirty_pages.size() < max_pages; i++) {
+    Page &page = pages_[candidates[i]];
+    if (flushing_.count(page.page_id_) != 0) {
+      // dirtied again while its previous write is in flight, leave it to the next round
+      continue;
+    }
+    char *data = staging + dirty_pages.size() * PAGE_SIZE;
+    memcpy(data, page.data_, PAGE_SIZE);
+    page.is_dirty_ = false;
+    CountersOf(page).dirty_writebacks++;
+    flushing_.insert(page.page_id_);
+    dirty_pages.push_back({page.page_id_, this, data});
+    collected++;
+  }
+  return collected;
+}
+
+void BufferPoolManager::WakeBackgroundWriter() {
+  BufferPoolManager *host = bg_writer_host_;
+  if (!host->bg_writer_wakeup_.exchange(true)) {
+    host->bg_writer_cv_.notify_one();
+  }
+}
+
+void BufferPoolManager::FinishBackgroundWrite(page_id_t page_id) {
+  {
+    std::scoped_lock<std::mutex> lock(io_latch_);
+    flushing_.erase(page_id);
+  }
+  io_cv_.notify_all();
+}
+
+void BufferPoolManager::WaitForBackgroundWrite(page_id_t page_id) {
+  std::unique_lock<std::mutex> lock(io_latch_);
+  if (flushing_.count(page_id) == 0) return;
+  fg_write_waits_++;
+  auto start = std::chrono::steady_clock::now();
+  io_cv_.wait(lock, [this, page_id] { return flushing_.count(page_id) == 0; });
+  RecordPinWait(start);
+}
+
+Page *BufferPoolManager::TryPinPinnedPage(page_id_t page_id) {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, frame_id)) return nullptr;
+  Page &page = pages_[frame_id];
+  int pin_count = page.pin_count_.load();
+  do {
+    // 没人pin的帧可能正被换出，交给latch下的路径
+    if (pin_count <= 0) return nullptr;
+  } while (!page.pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+  // pin住之后帧不会再换页，Find和pin之间帧可能已经换成别的页
+  if (page.page_id_ != page_id || reading_[frame_id]) {
+    UndoPin(frame_id);
+    return nullptr;
+  }
+  TouchPage(page);
+  CountersOf(page).hits++;
+  return &page;
+}
+
+void BufferPoolManager::UndoPin(frame_id_t frame_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  if (--pages_[frame_id].pin_count_ == 0) {
+    if (static_cast<size_t>(frame_id) >= pool_size_) {
+      RetireFrame(frame_id);
+    } else if (ring_owner_[frame_id] == nullptr) {
+      replacer_->Unpin(frame_id);
+    }
+  }
+}
+
+Page *BufferPoolManager::TryFetchPage(page_id_t page_id) {
+  if (page_id > MAX_VALID_PAGE_ID || page_id <= INVALID_PAGE_ID) return nullptr;
+  if (read_only_) return FetchMappedPage(page_id);
+  std::unique_lock<std::recursive_mutex> lock = LockForPin();
+  frame_id_t tmp;
+  if (!page_table_.Find(page_id, tmp) || reading_[tmp]) return nullptr;
+  RecordAccess(page_id);
+  pages_[tmp].pin_count_++;
+  TouchPage(pages_[tmp]);
+  if (ring_owner_[tmp] == nullptr) replacer_->Pin(tmp);
+  CountersOf(pages_[tmp]).hits++;
+  return &pages_[tmp];
+}
+
+bool BufferPoolManager::IsPageReady(page_id_t page_id) {
+  if (read_only_) return disk_manager_->MapPage(page_id) != nullptr;
+  frame_id_t frame_id;
+  return page_table_.Find(page_id, frame_id) && !reading_[frame_id];
+}
+
+void BufferPoolManager::PrefetchPages(const std::vector<page_id_t> &page_ids, BufferRing *ring) {
+  ASSERT(ring == nullptr || ring->bpm_ == this, "Buffer ring belongs to another buffer pool.");
+  if (prefetcher_ == nullptr) return;
+  for (auto page_id : page_ids) {
+    frame_id_t frame_id;
+    // the page table can be probed without the latch, resident pages are not worth a request
+    if (page_id > MAX_VALID_PAGE_ID || page_id <= INVALID_PAGE_ID || page_table_.Find(page_id, frame_id)) continue;
+    prefetcher_->Submit(this, page_id, ring);
+  }
+}
+
+void BufferPoolManager::StartPrefetcher(size_t num_threads) {
+  // a read-only pool reads nothing, the pages are mapped
+  if (prefetcher_ == nullptr && num_threads > 0 && !read_only_) {
+    prefetcher_ = std::make_unique<Prefetcher>(num_threads);
+  }
+}
+
+void BufferPoolManager::StopPrefetcher() { prefetcher_.reset(); }
+
+void BufferPoolManager::SetAccessTrace(PageAccessTrace *trace) { access_trace_ = trace; }
+
+std::vector<page_id_t> BufferPoolManager::GetResidentPages() {
+  std::vector<std::pair<int64_t, page_id_t>> resident_pages;
+  CollectResidentPages(resident_pages);
+  std::sort(resident_pages.begin(), resident_pages.end(), std::greater<>());
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(resident_pages.size());
+  for (auto &resident_page : resident_pages) {
+    page_ids.push_back(resident_page.second);
+  }
+  return page_ids;
+}
+
+void BufferPoolManager::CollectResidentPages(vector<pair<int64_t, page_id_t>> &resident_pages) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  page_table_.ForEach([this, &resident_pages](page_id_t page_id, frame_id_t frame_id) {
+    resident_pages.emplace_back(pages_[frame_id].last_used_, page_id);
+  });
+}
+
+bool BufferPoolManager::SaveResidentPages(const std::string &file_name) {
+  std::string tmp_file_name = file_name + ".tmp";
+  {
+    std::ofstream out(tmp_file_name, std::ios::trunc);
+    for (auto page_id : GetResidentPages()) {
+      out << page_id << '\n';
+    }
+    if (!out.flush()) {
+      remove(tmp_file_name.c_str());
+      return false;
+    }
+  }
+  // 先写临时文件再改名，崩溃时不会留下写了一半的列表
+  return rename(tmp_file_name.c_str(), file_name.c_str()) == 0;
+}
+
+size_t BufferPoolManager::WarmUp(const std::string &file_name) {
+  if (!IsPrefetching()) return 0;
+  std::ifstream in(file_name);
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id;
+  size_t pool_size = GetPoolSize();
+  while (page_ids.size() < pool_size && in >> page_id) {
+    page_ids.push_back(page_id);
+  }
+  // 列表按最近使用排序，按页号重排后预读线程顺序读盘
+  std::sort(page_ids.begin(), page_ids.end());
+  page_ids.erase(std::unique(page_ids.begin(), page_ids.end()), page_ids.end());
+  PrefetchPages(page_ids);
+  return page_ids.size();
+}
+
+bool BufferPoolManager::PrefetchPage(page_id_t page_id, BufferRing *ring) {
+  std::unique_lock<std::recursive_mutex> lock(latch_);
+  frame_id_t tmp;
+  if (page_table_.Find(page_id, tmp)) return false;
+  if (ring != nullptr ? !TryToFindRingFrame(ring, tmp) : !TryToFindFreeFrame(tmp)) return false;
+  page_table_.Insert(page_id, tmp);
+  pages_[tmp].page_id_ = page_id;
+  pages_[tmp].is_dirty_ = false;
+  pages_[tmp].last_used_ = 0;  // read ahead, nobody has used it yet
+  reading_[tmp] = true;        // before the pin, TryPinPinnedPage() must not hand out the frame during the read
+  pages_[tmp].pin_count_ = 1;
+  lock.unlock();
+
+  WaitForBackgroundWrite(page_id);
+  disk_manager_->ReadPage(page_id, pages_[tmp].data_);
+  pages_[tmp].kind_ = ClassifyPage(page_id, pages_[tmp].data_);
+  {
+    std::scoped_lock<std::mutex> io_lock(io_latch_);
+    reading_[tmp] = false;
+  }
+  io_cv_.notify_all();
+
+  // nobody asked for the page yet, it waits in the replacer like any unpinned page
+  lock.lock();
+  if (--pages_[tmp].pin_count_ == 0) {
+    if (static_cast<size_t>(tmp) >= pool_size_) {
+      RetireFrame(tmp);  // the pool shrank during the read
+    } else if (ring_owner_[tmp] == nullptr) {
+      replacer_->Unpin(tmp);
+    }
+  }
+  return true;
+}
+
+void BufferPoolManager::WaitForRead(frame_id_t frame_id) {
+  std::unique_lock<std::mutex> lock(io_latch_);
+  if (!reading_[frame_id]) return;
+  auto start = std::chrono::steady_clock::now();
+  io_cv_.wait(lock, [this, frame_id] { return !reading_[frame_id]; });
+  RecordPinWait(start);
+}
+
+Page *BufferPoolManager::FetchMappedPage(page_id_t page_id) {
+  const char *data = disk_manager_->MapPage(page_id);
+  if (data == nullptr) return nullptr;
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  size_t chunk = page_id / MAPPED_PAGES_PER_CHUNK;
+  if (chunk >= mapped_pages_.size()) {
+    mapped_pages_.resize(chunk + 1);
+  }
+  if (mapped_pages_[chunk] == nullptr) {
+    mapped_pages_[chunk] = NewDescriptors(MAPPED_PAGES_PER_CHUNK, nullptr);
+  }
+  Page &page = mapped_pages_[chunk][page_id % MAPPED_PAGES_PER_CHUNK];
+  page.page_id_ = page_id;
+  // the mapping is read-only, writing to the page faults
+  page.data_ = const_cast<char *>(data);
+  page.pin_count_++;
+  page.kind_ = ClassifyPage(page_id, data);
+  CountersOf(page).hits++;
+  return &page;
+}
+
+Page *BufferPoolManager::FindMappedPage(page_id_t page_id) {
+  size_t chunk = page_id / MAPPED_PAGES_PER_CHUNK;
+  if (page_id < 0 || chunk >= mapped_pages_.size() || mapped_pages_[chunk] == nullptr) return nullptr;
+  Page &page = mapped_pages_[chunk][page_id % MAPPED_PAGES_PER_CHUNK];
+  return page.data_ == nullptr ? nullptr : &page;
+}
+
+Page *BufferPoolManager::NewDescriptors(size_t num_pages, char *data) {
+  Page *pages = AllocateDescriptors(num_pages);
+  ConstructDescriptors(pages, 0, num_pages, data);
+  return pages;
+}
+
+Page *BufferPoolManager::AllocateDescriptors(size_t num_pages) {
+  return static_cast<Page *>(::operator new[](num_pages * sizeof(Page), std::align_val_t(alignof(Page))));
+}
+
+void BufferPoolManager::ConstructDescriptors(Page *pages, size_t from, size_t to, char *data) {
+  for (size_t i = from; i < to; i++) {
+    new (&pages[i]) Page(data == nullptr ? nullptr : data + i * PAGE_SIZE);
+  }
+}
+
+void BufferPoolManager::DeleteDescriptors(Page *pages, size_t num_pages) {
+  if (pages == nullptr) return;
+  for (size_t i = 0; i < num_pages; i++) {
+    pages[i].~Page();
+  }
+  ::operator delete[](pages, std::align_val_t(alignof(Page)));
 }
 
 page_id_t BufferPoolManager::AllocatePage() {
@@ -173,6 +830,8 @@ page_id_t BufferPoolManager::AllocatePage() {
   return next_page_id;
 }
 
+page_id_t BufferPoolManager::AllocatePages(size_t num_pages) { return disk_manager_->AllocatePages(num_pages); }
+
 void BufferPoolManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {
   disk_manager_->DeAllocatePage(page_id);
 }
@@ -183,12 +842,21 @@ bool BufferPoolManager::IsPageFree(page_id_t page_id) {
 
 // Only used for debug
 bool BufferPoolManager::CheckAllUnpinned() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   bool res = true;
-  for (size_t i = 0; i < pool_size_; i++) {
+  for (size_t i = 0; i < num_constructed_; i++) {
     if (pages_[i].pin_count_ != 0) {
       res = false;
       LOG(ERROR) << "page " << pages_[i].page_id_ << " pin count:" << pages_[i].pin_count_ << endl;
     }
   }
+  for (auto &chunk : mapped_pages_) {
+    for (size_t i = 0; chunk != nullptr && i < MAPPED_PAGES_PER_CHUNK; i++) {
+      if (chunk[i].pin_count_ != 0) {
+        res = false;
+        LOG(ERROR) << "page " << chunk[i].page_id_ << " pin count:" << chunk[i].pin_count_ << endl;
+      }
+    }
+  }
   return res;
 }
\ No newline at end of file
@@ -0,0 +1,26 @@
+#include "buffer/buffer_ring.h"
+
+#include "buffer/buffer_pool_manager.h"
+
+BufferRing::~BufferRing() {
+  {
+    std::unique_lock<std::mutex> lock(prefetch_latch_);
+    prefetch_cv_.wait(lock, [this] { return pending_prefetches_ == 0; });
+  }
+  // the rings of a parallel buffer pool release their frames one shard at a time
+  if (shards_.empty()) {
+    bpm_->ReleaseBufferRing(this);
+  }
+}
+
+void BufferRing::BeginPrefetch() {
+  std::scoped_lock<std::mutex> lock(prefetch_latch_);
+  pending_prefetches_++;
+}
+
+void BufferRing::EndPrefetch() {
+  std::scoped_lock<std::mutex> lock(prefetch_latch_);
+  if (--pending_prefetches_ == 0) {
+    prefetch_cv_.notify_all();
+  }
+}
@@ -0,0 +1,54 @@
+#include "buffer/clock_replacer.h"
+
+CLOCKReplacer::CLOCKReplacer(size_t num_pages)
+    : capacity_(num_pages), evictable_(num_pages, false), referenced_(num_pages, false) {}
+
+CLOCKReplacer::~CLOCKReplacer() = default;
+
+bool CLOCKReplacer::Victim(frame_id_t *frame_id) {
+  // a frame with its reference bit set gets a second chance, so the hand goes round at most twice
+  while (size_ > 0) {
+    size_t frame = hand_;
+    hand_ = (hand_ + 1) % evictable_.size();
+    if (!evictable_[frame]) {
+      continue;
+    }
+    if (referenced_[frame]) {
+      referenced_[frame] = false;
+      continue;
+    }
+    evictable_[frame] = false;
+    size_--;
+    *frame_id = static_cast<frame_id_t>(frame);
+    return true;
+  }
+  return false;
+}
+
+void CLOCKReplacer::Pin(frame_id_t frame_id) {
+  if (static_cast<size_t>(frame_id) < evictable_.size() && evictable_[frame_id]) {
+    evictable_[frame_id] = false;
+    size_--;
+  }
+}
+
+void CLOCKReplacer::Unpin(frame_id_t frame_id) {
+  if (size_ >= capacity_ || static_cast<size_t>(frame_id) >= evictable_.size() || evictable_[frame_id]) {
+    return;
+  }
+  evictable_[frame_id] = true;
+  referenced_[frame_id] = true;
+  size_++;
+}
+
+size_t CLOCKReplacer::Size() { return size_; }
+
+void CLOCKReplacer::SetCapacity(size_t num_pages) {
+  // the frames beyond a smaller capacity have been removed, so the hand only needs to sweep the remaining ones
+  evictable_.resize(num_pages, false);
+  referenced_.resize(num_pages, false);
+  if (hand_ >= num_pages) {
+    hand_ = 0;
+  }
+  capacity_ = num_pages;
+}
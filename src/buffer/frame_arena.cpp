@@ -0,0 +1,71 @@
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+static size_t RoundUp(size_t size, size_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+
+FrameArena::FrameArena(size_t num_frames, size_t max_frames) : num_frames_(std::max(num_frames, max_frames)) {
+  size_t size = num_frames_ * PAGE_SIZE;
+  if (size == 0) {
+    return;
+  }
+  // 为扩容预留的地址空间不占用内存，也不计入overcommit
+  bool growable = num_frames_ > num_frames;
+  int reserve_flags = growable ? MAP_NORESERVE : 0;
+  if (size >= HUGE_PAGE_SIZE) {
+    // 预留了大页时直接使用hugetlb
+    size_t huge_size = RoundUp(size, HUGE_PAGE_SIZE);
+    void *map = growable ? MAP_FAILED
+                         : mmap(nullptr, huge_size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (map != MAP_FAILED) {
+      data_ = static_cast<char *>(map);
+      mapped_size_ = huge_size;
+      backing_ = FrameArenaBacking::kHugeTLB;
+      return;
+    }
+    // 否则多映射一个大页，裁掉首尾使起点按大页对齐，再建议内核使用透明大页
+    map = mmap(nullptr, huge_size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | reserve_flags,
+               -1, 0);
+    if (map == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    auto start = reinterpret_cast<uintptr_t>(map);
+    auto aligned = RoundUp(start, HUGE_PAGE_SIZE);
+    if (aligned > start) {
+      munmap(map, aligned - start);
+    }
+    munmap(reinterpret_cast<void *>(aligned + huge_size), HUGE_PAGE_SIZE - (aligned - start));
+    data_ = reinterpret_cast<char *>(aligned);
+    mapped_size_ = huge_size;
+    backing_ = madvise(data_, mapped_size_, MADV_HUGEPAGE) == 0 ? FrameArenaBacking::kTransparentHuge
+                                                                 : FrameArenaBacking::kRegularPages;
+    return;
+  }
+  void *map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | reserve_flags, -1, 0);
+  if (map == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  data_ = static_cast<char *>(map);
+  mapped_size_ = size;
+  backing_ = FrameArenaBacking::kRegularPages;
+}
+
+FrameArena::~FrameArena() {
+  if (data_ != nullptr) {
+    munmap(data_, mapped_size_);
+  }
+}
+
+void FrameArena::Release(size_t first_frame, size_t num_frames) {
+  if (num_frames == 0 || first_frame >= num_frames_) {
+    return;
+  }
+  num_frames = std::min(num_frames, num_frames_ - first_frame);
+  // 只是归还内存的建议，失败时帧照常可用（例如未按大页对齐的hugetlb区间）
+  madvise(GetFrame(first_frame), num_frames * PAGE_SIZE, MADV_DONTNEED);
+}
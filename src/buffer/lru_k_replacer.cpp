@@ -0,0 +1,83 @@
+#include "buffer/lru_k_replacer.h"
+
+#include "common/macros.h"
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k) : k_(k), history_(num_pages), evictable_(num_pages, false) {
+  ASSERT(k_ > 0, "LRU-K needs k >= 1.");
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+LRUKReplacer::EvictKey LRUKReplacer::KeyOf(frame_id_t frame_id) const {
+  // history_ is oldest first, so its front is the k-th most recent access once it is full
+  const auto &history = history_[frame_id];
+  return {history.size() < k_ ? history.back() : history.front(), frame_id};
+}
+
+void LRUKReplacer::Evict(frame_id_t frame_id) {
+  if (!evictable_[frame_id]) {
+    return;
+  }
+  auto key = KeyOf(frame_id);
+  (history_[frame_id].size() < k_ ? cold_ : hot_).erase(key);
+  evictable_[frame_id] = false;
+}
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  // infinite backward k-distance first, then the largest one
+  auto &candidates = cold_.empty() ? hot_ : cold_;
+  if (candidates.empty()) {
+    return false;
+  }
+  *frame_id = candidates.begin()->second;
+  candidates.erase(candidates.begin());
+  evictable_[*frame_id] = false;
+  history_[*frame_id].clear();
+  if (last_accessed_ == *frame_id) {
+    last_accessed_ = INVALID_FRAME_ID;
+  }
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  Evict(frame_id);
+  auto &history = history_[frame_id];
+  if (frame_id == last_accessed_ && !history.empty()) {
+    // correlated with the previous access, it is the same reference
+    return;
+  }
+  last_accessed_ = frame_id;
+  history.push_back(++current_timestamp_);
+  if (history.size() > k_) {
+    history.pop_front();
+  }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  if (evictable_[frame_id]) {
+    return;
+  }
+  if (history_[frame_id].empty()) {
+    // never accessed through Pin(), treat the unpin as its first access
+    history_[frame_id].push_back(++current_timestamp_);
+  }
+  (history_[frame_id].size() < k_ ? cold_ : hot_).insert(KeyOf(frame_id));
+  evictable_[frame_id] = true;
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  Evict(frame_id);
+  history_[frame_id].clear();
+  if (last_accessed_ == frame_id) {
+    last_accessed_ = INVALID_FRAME_ID;
+  }
+}
+
+size_t LRUKReplacer::Size() { return cold_.size() + hot_.size(); }
+
+void LRUKReplacer::SetCapacity(size_t num_pages) {
+  if (num_pages > history_.size()) {
+    history_.resize(num_pages);
+    evictable_.resize(num_pages, false);
+  }
+}
@@ -1,53 +1,73 @@
 #include "buffer/lru_replacer.h"
 
-LRUReplacer::LRUReplacer(size_t num_pages) : cache(num_pages, lru_list.end()) {
-  num_page = num_pages;
-}
+LRUReplacer::LRUReplacer(size_t num_pages)
+    : num_pages_(num_pages),
+      prev_(num_pages, INVALID_FRAME_ID),
+      next_(num_pages, INVALID_FRAME_ID),
+      linked_(num_pages, false) {}
 
 LRUReplacer::~LRUReplacer() = default;
-/**
- * TODO: Student Implement
- */
+
 bool LRUReplacer::Victim(frame_id_t *frame_id) {
-  if (lru_list.empty()!=0)//如果为空则返回false
-   {
+  if (tail_ == INVALID_FRAME_ID) {  //如果为空则返回false
     return false;
   }
-  else {
-    *frame_id = lru_list.back();//返回最近最少被访问的页
-    cache[*frame_id] = lru_list.end();//将其从lru_list_中移除
-    lru_list.pop_back();//删除
-    return true;
-  }
+  *frame_id = tail_;  //返回最近最少被访问的页
+  Unlink(tail_);
+  return true;
 }
-/**
- * TODO: Student Implement
- */
+
 void LRUReplacer::Pin(frame_id_t frame_id) {
-  auto temp = cache[frame_id];
-  if (temp != lru_list.end()) {
-    // 存在对应元素
-    lru_list.erase(temp);
-    cache[frame_id] = lru_list.end();
+  if (static_cast<size_t>(frame_id) < linked_.size() && linked_[frame_id]) {
+    Unlink(frame_id);
   }
 }
-/**
- * TODO: Student Implement
- */
+
 void LRUReplacer::Unpin(frame_id_t frame_id) {
-  if (lru_list.size() >= num_page ) {
+  if (size_ >= num_pages_ || static_cast<size_t>(frame_id) >= linked_.size() || linked_[frame_id]) {
     return;
   }
-  else if (cache[frame_id] != lru_list.end()){
-    return ;
+  Link(frame_id);
+}
+
+size_t LRUReplacer::Size() { return size_; }
+
+void LRUReplacer::SetCapacity(size_t num_pages) {
+  if (num_pages > linked_.size()) {
+    prev_.resize(num_pages, INVALID_FRAME_ID);
+    next_.resize(num_pages, INVALID_FRAME_ID);
+    linked_.resize(num_pages, false);
   }
-  else{
-    lru_list.push_front(frame_id);
-    cache[frame_id] = lru_list.begin();
+  num_pages_ = num_pages;
+}
+
+void LRUReplacer::Link(frame_id_t frame_id) {
+  //插入链表头
+  prev_[frame_id] = INVALID_FRAME_ID;
+  next_[frame_id] = head_;
+  if (head_ != INVALID_FRAME_ID) {
+    prev_[head_] = frame_id;
+  } else {
+    tail_ = frame_id;
   }
+  head_ = frame_id;
+  linked_[frame_id] = true;
+  size_++;
+}
 
+void LRUReplacer::Unlink(frame_id_t frame_id) {
+  frame_id_t prev = prev_[frame_id];
+  frame_id_t next = next_[frame_id];
+  if (prev != INVALID_FRAME_ID) {
+    next_[prev] = next;
+  } else {
+    head_ = next;
+  }
+  if (next != INVALID_FRAME_ID) {
+    prev_[next] = prev;
+  } else {
+    tail_ = prev;
+  }
+  linked_[frame_id] = false;
+  size_--;
 }
-/**
- * TODO: Student Implement
- */
-size_t LRUReplacer::Size() { return lru_list.size(); }
\ No newline at end of file
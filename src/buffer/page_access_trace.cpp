@@ -0,0 +1,31 @@
+#include "buffer/page_access_trace.h"
+
+#include <fstream>
+
+void PageAccessTrace::Record(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  page_ids_.push_back(page_id);
+}
+
+std::vector<page_id_t> PageAccessTrace::GetPageIds() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return page_ids_;
+}
+
+bool PageAccessTrace::Save(const std::string &file_name) {
+  std::vector<page_id_t> page_ids = GetPageIds();
+  std::ofstream out(file_name, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(page_ids.data()), page_ids.size() * sizeof(page_id_t));
+  return static_cast<bool>(out.flush());
+}
+
+bool PageAccessTrace::Load(const std::string &file_name, std::vector<page_id_t> &page_ids) {
+  std::ifstream in(file_name, std::ios::binary | std::ios::ate);
+  if (!in) {
+    return false;
+  }
+  size_t size = in.tellg();
+  page_ids.resize(size / sizeof(page_id_t));
+  in.seekg(0);
+  return static_cast<bool>(in.read(reinterpret_cast<char *>(page_ids.data()), page_ids.size() * sizeof(page_id_t)));
+}
@@ -0,0 +1,63 @@
+#include "buffer/page_table.h"
+
+PageTable::PageTable(size_t num_frames) {
+  // keep the load factor at or below 1/2 so that probe sequences stay short
+  uint32_t bits = 1;
+  while ((static_cast<size_t>(1) << bits) < 2 * num_frames) {
+    bits++;
+  }
+  mask_ = (static_cast<size_t>(1) << bits) - 1;
+  shift_ = 32 - bits;
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(mask_ + 1);
+  for (size_t i = 0; i <= mask_; i++) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  for (size_t pos = Hash(page_id);; pos = (pos + 1) & mask_) {
+    uint64_t slot = slots_[pos].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      ASSERT(size_ < mask_, "Page table is full.");
+      size_++;
+      slots_[pos].store(MakeSlot(page_id, frame_id), std::memory_order_release);
+      return;
+    }
+    if (KeyOf(slot) == page_id) {
+      slots_[pos].store(MakeSlot(page_id, frame_id), std::memory_order_release);
+      return;
+    }
+  }
+}
+
+bool PageTable::Erase(page_id_t page_id) {
+  size_t hole = Hash(page_id);
+  for (;; hole = (hole + 1) & mask_) {
+    uint64_t slot = slots_[hole].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (KeyOf(slot) == page_id) {
+      break;
+    }
+  }
+  // Backward-shift deletion: pull later entries of the cluster into the hole when their home slot allows it. The
+  // erased entry is overwritten in place rather than emptied first, so lookups of other keys passing through the
+  // hole never stop early on it.
+  for (size_t pos = (hole + 1) & mask_;; pos = (pos + 1) & mask_) {
+    uint64_t slot = slots_[pos].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    size_t home = Hash(KeyOf(slot));
+    // the entry may move iff its home is not cyclically inside (hole, pos]
+    bool movable = hole <= pos ? (home <= hole || home > pos) : (home <= hole && home > pos);
+    if (movable) {
+      slots_[hole].store(slot, std::memory_order_release);
+      hole = pos;
+    }
+  }
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+  size_--;
+  return true;
+}
@@ -0,0 +1,190 @@
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+
+// hand out the remainder one frame at a time to the first shards
+static size_t ShardSize(size_t pool_size, size_t num_instances, size_t instance) {
+  return pool_size / num_instances + (instance < pool_size % num_instances ? 1 : 0);
+}
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, ReplacerType replacer_type,
+                                                     size_t max_pool_size)
+    : BufferPoolManager(disk_manager) {
+  ASSERT(num_instances > 0, "A parallel buffer pool needs at least one instance.");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    size_t instance_size = ShardSize(pool_size, num_instances, i);
+    size_t instance_max_size = ShardSize(max_pool_size, num_instances, i);
+    instances_.push_back(new BufferPoolManager(instance_size, disk_manager, replacer_type, instance_max_size));
+    instances_.back()->bg_writer_host_ = this;
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  // the I/O threads and the background writer work on the shards, stop them before the shards go away
+  StopPrefetcher();
+  StopBackgroundWriter();
+  for (auto instance : instances_) {
+    delete instance;
+  }
+}
+
+Page *ParallelBufferPoolManager::FetchPage(page_id_t page_id) {
+  if (page_id > MAX_VALID_PAGE_ID || page_id <= INVALID_PAGE_ID) return nullptr;
+  return GetInstance(page_id)->FetchPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::FetchPage(page_id_t page_id, BufferRing *ring) {
+  if (ring == nullptr) return FetchPage(page_id);
+  ASSERT(ring->bpm_ == this, "Buffer ring belongs to another buffer pool.");
+  if (page_id > MAX_VALID_PAGE_ID || page_id <= INVALID_PAGE_ID) return nullptr;
+  auto shard = static_cast<uint32_t>(page_id) % instances_.size();
+  return instances_[shard]->FetchPage(page_id, ring->shards_[shard].get());
+}
+
+std::unique_ptr<BufferRing> ParallelBufferPoolManager::NewBufferRing(size_t ring_size) {
+  ASSERT(ring_size > 0, "A buffer ring needs at least one frame.");
+  std::unique_ptr<BufferRing> ring(new BufferRing(this, ring_size));
+  size_t shard_ring_size = std::max<size_t>(1, ring_size / instances_.size());
+  for (auto instance : instances_) {
+    ring->shards_.push_back(instance->NewBufferRing(shard_ring_size));
+  }
+  return ring;
+}
+
+Page *ParallelBufferPoolManager::TryFetchPage(page_id_t page_id) {
+  if (page_id > MAX_VALID_PAGE_ID || page_id <= INVALID_PAGE_ID) return nullptr;
+  return GetInstance(page_id)->TryFetchPage(page_id);
+}
+
+bool ParallelBufferPoolManager::IsPageReady(page_id_t page_id) {
+  if (page_id > MAX_VALID_PAGE_ID || page_id <= INVALID_PAGE_ID) return false;
+  return GetInstance(page_id)->IsPageReady(page_id);
+}
+
+void ParallelBufferPoolManager::PrefetchPages(const std::vector<page_id_t> &page_ids, BufferRing *ring) {
+  ASSERT(ring == nullptr || ring->bpm_ == this, "Buffer ring belongs to another buffer pool.");
+  if (prefetcher_ == nullptr) return;
+  for (auto page_id : page_ids) {
+    if (page_id > MAX_VALID_PAGE_ID || page_id <= INVALID_PAGE_ID) continue;
+    auto shard = static_cast<uint32_t>(page_id) % instances_.size();
+    frame_id_t frame_id;
+    if (instances_[shard]->page_table_.Find(page_id, frame_id)) continue;
+    prefetcher_->Submit(instances_[shard], page_id, ring == nullptr ? nullptr : ring->shards_[shard].get());
+  }
+}
+
+bool ParallelBufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  if (page_id > MAX_VALID_PAGE_ID || page_id <= INVALID_PAGE_ID) return false;
+  return GetInstance(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPage(page_id_t page_id) {
+  if (page_id > MAX_VALID_PAGE_ID || page_id <= INVALID_PAGE_ID) return false;
+  return GetInstance(page_id)->FlushPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPage(page_id_t &page_id) {
+  // the disk manager serializes allocations, so the shard is only known once the id has been handed out
+  page_id = AllocatePage();
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  Page *page = GetInstance(page_id)->NewPageWithId(page_id);
+  if (page == nullptr) {
+    DeallocatePage(page_id);
+    page_id = INVALID_PAGE_ID;
+  }
+  return page;
+}
+
+Page *ParallelBufferPoolManager::NewPageWithId(page_id_t page_id) {
+  return GetInstance(page_id)->NewPageWithId(page_id);
+}
+
+bool ParallelBufferPoolManager::DeletePage(page_id_t page_id) {
+  if (page_id > MAX_VALID_PAGE_ID || page_id <= INVALID_PAGE_ID) return true;
+  return GetInstance(page_id)->DeletePage(page_id);
+}
+
+bool ParallelBufferPoolManager::CheckAllUnpinned() {
+  bool res = true;
+  for (auto instance : instances_) {
+    res = instance->CheckAllUnpinned() && res;
+  }
+  return res;
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() {
+  size_t size = 0;
+  for (auto instance : instances_) {
+    size += instance->GetPoolSize();
+  }
+  return size;
+}
+
+size_t ParallelBufferPoolManager::GetMaxPoolSize() {
+  size_t size = 0;
+  for (auto instance : instances_) {
+    size += instance->GetMaxPoolSize();
+  }
+  return size;
+}
+
+void ParallelBufferPoolManager::SetAccessTrace(PageAccessTrace *trace) {
+  for (auto instance : instances_) {
+    instance->SetAccessTrace(trace);
+  }
+}
+
+bool ParallelBufferPoolManager::Resize(size_t pool_size) {
+  for (size_t i = 0; i < instances_.size(); i++) {
+    size_t instance_size = ShardSize(pool_size, instances_.size(), i);
+    if (instance_size == 0 || instance_size > instances_[i]->GetMaxPoolSize()) return false;
+  }
+  for (size_t i = 0; i < instances_.size(); i++) {
+    instances_[i]->Resize(ShardSize(pool_size, instances_.size(), i));
+  }
+  return true;
+}
+
+BufferWriterStats ParallelBufferPoolManager::GetWriterStats() {
+  BufferWriterStats stats = BufferPoolManager::GetWriterStats();
+  for (auto instance : instances_) {
+    BufferWriterStats instance_stats = instance->GetWriterStats();
+    stats.evictions += instance_stats.evictions;
+    stats.fg_victim_writes += instance_stats.fg_victim_writes;
+    stats.fg_write_waits += instance_stats.fg_write_waits;
+  }
+  return stats;
+}
+
+BufferPoolStats ParallelBufferPoolManager::GetBufferStats() {
+  BufferPoolStats stats;
+  for (auto instance : instances_) {
+    stats.Merge(instance->GetBufferStats());
+  }
+  return stats;
+}
+
+FrameArenaBacking ParallelBufferPoolManager::GetFrameBacking() {
+  return instances_.empty() ? FrameArenaBacking::kNone : instances_[0]->GetFrameBacking();
+}
+
+size_t ParallelBufferPoolManager::CollectDirtyPages(double clean_ratio, char *staging, size_t max_pages,
+                                                    vector<DirtyPage> &dirty_pages) {
+  size_t collected = 0;
+  for (size_t i = 0; i < instances_.size() && dirty_pages.size() < max_pages; i++) {
+    auto instance = instances_[(next_collect_instance_ + i) % instances_.size()];
+    collected += instance->CollectDirtyPages(clean_ratio, staging, max_pages, dirty_pages);
+  }
+  next_collect_instance_ = (next_collect_instance_ + 1) % instances_.size();
+  return collected;
+}
+
+void ParallelBufferPoolManager::CollectResidentPages(vector<pair<int64_t, page_id_t>> &resident_pages) {
+  for (auto instance : instances_) {
+    instance->CollectResidentPages(resident_pages);
+  }
+}
@@ -0,0 +1,57 @@
+#include "buffer/prefetcher.h"
+
+#include "buffer/buffer_pool_manager.h"
+
+Prefetcher::Prefetcher(size_t num_threads) {
+  for (size_t i = 0; i < num_threads; i++) {
+    workers_.emplace_back(&Prefetcher::WorkerLoop, this);
+  }
+}
+
+Prefetcher::~Prefetcher() {
+  std::deque<Request> dropped;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stop_ = true;
+    dropped.swap(requests_);
+  }
+  cv_.notify_all();
+  for (auto &request : dropped) {
+    if (request.ring != nullptr) {
+      request.ring->EndPrefetch();
+    }
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void Prefetcher::Submit(BufferPoolManager *bpm, page_id_t page_id, BufferRing *ring) {
+  if (ring != nullptr) {
+    // the ring must outlive every request which refers to it
+    ring->BeginPrefetch();
+  }
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    requests_.push_back({bpm, page_id, ring});
+  }
+  cv_.notify_one();
+}
+
+void Prefetcher::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    cv_.wait(lock, [this] { return stop_ || !requests_.empty(); });
+    if (stop_) {
+      return;
+    }
+    Request request = requests_.front();
+    requests_.pop_front();
+    lock.unlock();
+    request.bpm->PrefetchPage(request.page_id, request.ring);
+    if (request.ring != nullptr) {
+      request.ring->EndPrefetch();
+    }
+    lock.lock();
+  }
+}
@@ -109,6 +109,7 @@ CatalogManager::~CatalogManager() {
  */
 dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schema, Txn *txn, TableInfo *&table_info) {
   // ASSERT(false, "Not Implemented yet");
+  if (buffer_pool_manager_->IsReadOnly()) return DB_READ_ONLY;
   try {
     // Does the table exist?
     auto iter = table_names_.find(table_name);
@@ -120,7 +121,6 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     page_id_t meta_page_id = 0;
     Page *meta_page = nullptr;
     page_id_t table_page_id = 0;
-    Page *table_page = nullptr;
     table_id_t table_id = 0;
     TableMetadata *table_meta_ = nullptr;
     TableHeap *table_heap_ = nullptr;
@@ -133,13 +133,12 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     schema_ = schema_->DeepCopySchema(schema);
     // get new table meta page
     meta_page = buffer_pool_manager_->NewPage(meta_page_id);
-    // get new table page
-    table_page = buffer_pool_manager_->NewPage(table_page_id);
+    // table init, the heap allocates its first page
+    table_heap_ = table_heap_->Create(buffer_pool_manager_, schema_, nullptr, nullptr, nullptr);
+    table_page_id = table_heap_->GetFirstPageId();
     // table meta init
     table_meta_ = table_meta_->Create(table_id, table_name, table_page_id, schema_);
     table_meta_->SerializeTo(meta_page->GetData());
-    // table init
-    table_heap_ = table_heap_->Create(buffer_pool_manager_, schema_, nullptr, nullptr, nullptr);
     // table info
     table_info->Init(table_meta_, table_heap_);
 
@@ -154,7 +153,6 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     catalog_meta_->SerializeTo(buf);
     buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, true);
     buffer_pool_manager_->UnpinPage(meta_page_id, true);
-    buffer_pool_manager_->UnpinPage(table_page_id, true);
     return DB_SUCCESS;
   } catch (exception e) {
     return DB_FAILED;
@@ -193,6 +191,7 @@ dberr_t CatalogManager::GetTables(vector<TableInfo *> &tables) const {
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Txn *txn, IndexInfo *&index_info,
                                     const string &index_type) {
+  if (buffer_pool_manager_->IsReadOnly()) return DB_READ_ONLY;
   try {
     // Does the table exist?
     auto iter_find_table = table_names_.find(table_name);
@@ -298,6 +297,7 @@ dberr_t CatalogManager::GetTableIndexes(const std::string &table_name, std::vect
  * TODO: Student Implement
  */
 dberr_t CatalogManager::DropTable(const string &table_name) {
+  if (buffer_pool_manager_->IsReadOnly()) return DB_READ_ONLY;
   // not found
   if (table_names_.find(table_name) == table_names_.end()) return DB_TABLE_NOT_EXIST;
   // get table through hash map
@@ -315,6 +315,7 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
  * TODO: Student Implement
  */
 dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_name) {
+  if (buffer_pool_manager_->IsReadOnly()) return DB_READ_ONLY;
   try {
     index_id_t index_id = 0;
     // Does the index exist?
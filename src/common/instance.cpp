@@ -3,16 +3,38 @@
 //
 #include "common/instance.h"
 
-DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size)
+// 与数据库文件放在一起，记录关闭时缓冲池中的页，下次打开时预读
+static std::string WarmFileName(const std::string &db_file_name) { return db_file_name + ".warm"; }
+
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size,
+                                 uint32_t buffer_pool_instances, bool read_only, bool direct_io, bool compress_pages)
     : db_file_name_(std::move(db_name)), init_(init) {
+  ASSERT(!(init && read_only), "A read-only database cannot be initialized.");
   // Init database file if needed
   db_file_name_ = "./databases/" + db_file_name_;
   if (init_) {
     remove(db_file_name_.c_str());
+    remove(WarmFileName(db_file_name_).c_str());
   }
   // Initialize components
-  disk_mgr_ = new DiskManager(db_file_name_);
-  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+  if (read_only) {
+    // 只读映射：页直接从映射中取用，不需要缓冲帧、后台写和预读
+    disk_mgr_ = new DiskManager(db_file_name_, DiskIOBackend::kMmap);
+    bpm_ = new BufferPoolManager(0, disk_mgr_);
+    ASSERT(!bpm_->IsPageFree(CATALOG_META_PAGE_ID), "Invalid catalog meta page.");
+    ASSERT(!bpm_->IsPageFree(INDEX_ROOTS_PAGE_ID), "Invalid header page.");
+    catalog_mgr_ = new CatalogManager(bpm_, nullptr, nullptr, false);
+    return;
+  }
+  disk_mgr_ = new DiskManager(db_file_name_, DiskIOBackend::kPread, direct_io, compress_pages);
+  if (buffer_pool_instances > 1) {
+    bpm_ = new ParallelBufferPoolManager(buffer_pool_instances, buffer_pool_size, disk_mgr_, ReplacerType::kLRU,
+                                         MAX_BUFFER_POOL_SIZE);
+  } else {
+    bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_, ReplacerType::kLRU, MAX_BUFFER_POOL_SIZE);
+  }
+  bpm_->StartBackgroundWriter();
+  bpm_->StartPrefetcher();
 
   // Allocate static page for db storage engine
   if (init) {
@@ -39,10 +61,16 @@ DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer
     ASSERT(!bpm_->IsPageFree(INDEX_ROOTS_PAGE_ID), "Invalid header page.");
   }
   catalog_mgr_ = new CatalogManager(bpm_, nullptr, nullptr, init);
+  if (!init) {
+    bpm_->WarmUp(WarmFileName(db_file_name_));
+  }
 }
 
 DBStorageEngine::~DBStorageEngine() {
   delete catalog_mgr_;
+  if (!disk_mgr_->IsReadOnly()) {
+    bpm_->SaveResidentPages(WarmFileName(db_file_name_));
+  }
   delete bpm_;
   delete disk_mgr_;
 }
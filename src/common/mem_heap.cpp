@@ -0,0 +1,39 @@
+#include "common/mem_heap.h"
+
+#include <algorithm>
+
+MemHeap::~MemHeap() {
+  for (auto block : blocks_) {
+    delete[] block;
+  }
+}
+
+void MemHeap::Reset() {
+  // 只保留第一个block，它是按block_size_分配的
+  for (size_t i = 1; i < blocks_.size(); i++) {
+    delete[] blocks_[i];
+  }
+  if (blocks_.empty()) {
+    cur_ = end_ = nullptr;
+  } else {
+    blocks_.resize(1);
+    cur_ = blocks_[0];
+    end_ = blocks_[0] + block_size_;
+  }
+  num_allocations_ = 0;
+  allocated_bytes_ = 0;
+}
+
+void *MemHeap::AllocateBlock(size_t size) {
+  // 大的分配单独占一个block，当前block剩余的空间留给之后的小分配
+  if (size > block_size_ / 4 && !blocks_.empty()) {
+    char *block = new char[size];
+    blocks_.insert(blocks_.end() - 1, block);
+    return block;
+  }
+  char *block = new char[std::max(size, block_size_)];
+  blocks_.push_back(block);
+  cur_ = block + size;
+  end_ = block + std::max(size, block_size_);
+  return block;
+}
@@ -16,13 +16,17 @@ void DeleteExecutor::Init() {
 }
 
 bool DeleteExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-  if (child_executor_->Next(row, rid)) {
+  // 被删除的行和键只在处理当前元组时使用，不放进语句的heap
+  MemHeap *heap = exec_ctx_->GetTupleMemHeap();
+  if (heap != nullptr) heap->Reset();
+  Row src_row(heap);
+  if (child_executor_->Next(&src_row, rid)) {
     if (!table_info_->GetTableHeap()->MarkDelete(*rid, txn_)) {
       return false;
     }
-    Row key_row;
+    Row key_row(heap);
     for (auto info : index_info_) {  // 更新索引
-      row->GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
+      src_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
       info->GetIndex()->RemoveEntry(key_row, *rid, txn_);
     }
     return true;
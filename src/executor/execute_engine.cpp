@@ -96,7 +96,7 @@ dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<
   try {
     executor->Init();
     RowId rid{};
-    Row row{};
+    Row row(exec_ctx->GetMemHeap());
     while (executor->Next(&row, &rid)) {
       if (result_set != nullptr) {
         result_set->push_back(row);
@@ -150,6 +150,10 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
       return ExecuteExecfile(ast, context.get());
     case kNodeQuit:
       return ExecuteQuit(ast, context.get());
+    case kNodeShowBufferStatus:
+      return ExecuteShowBufferStatus(ast, context.get());
+    case kNodeSetVariable:
+      return ExecuteSetVariable(ast, context.get());
     default:
       break;
   }
@@ -241,6 +245,9 @@ void ExecuteEngine::ExecuteInformation(dberr_t result) {
     case DB_KEY_NOT_FOUND:
       cout << "Key not exists." << endl;
       break;
+    case DB_READ_ONLY:
+      cout << "Database is read-only." << endl;
+      break;
     case DB_QUIT:
       cout << "Bye." << endl;
       break;
@@ -564,7 +571,7 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
   if (DB_SUCCESS ==
       dbs_[current_db_]->catalog_mgr_->CreateIndex(tablename, indexname, index_keys, nullptr, index_info, "bptree")) {
     // 将所有内容插入到建立的索引之中
-    for (auto it = table_info->GetTableHeap()->Begin(nullptr); it != table_info->GetTableHeap()->End(); ++it) {
+    for (auto it = table_info->GetTableHeap()->Begin(nullptr, true); it != table_info->GetTableHeap()->End(); ++it) {
       vector<Field *> fields = it->GetFields();
       vector<Field> field_temps;
       vector<Column *> columns = table_info->GetSchema()->GetColumns();
@@ -714,3 +721,99 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
   }
   return DB_QUIT;
 }
+
+dberr_t ExecuteEngine::ExecuteShowBufferStatus(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteShowBufferStatus" << std::endl;
+#endif
+  if (current_db_.empty()) {
+    cout << "No database selected" << endl;
+    return DB_FAILED;
+  }
+  BufferPoolManager *bpm = dbs_[current_db_]->bpm_;
+  BufferPoolStats stats = bpm->GetBufferStats();
+  const char *kind_names[NUM_PAGE_KINDS] = {"other", "table", "index internal", "index leaf", "catalog"};
+  vector<string> header{"Page_kind", "Hits", "Misses", "Hit_ratio", "Evictions", "Dirty_writebacks"};
+  vector<vector<string>> rows;
+  auto add_row = [&rows](const string &name, const BufferKindStats &kind) {
+    uint64_t accesses = kind.hits + kind.misses;
+    std::stringstream ratio;
+    ratio << fixed << setprecision(4) << (accesses == 0 ? 0.0 : double(kind.hits) / accesses);
+    rows.push_back({name, to_string(kind.hits), to_string(kind.misses), ratio.str(), to_string(kind.evictions),
+                    to_string(kind.dirty_writebacks)});
+  };
+  for (size_t i = 0; i < NUM_PAGE_KINDS; i++) {
+    add_row(kind_names[i], stats.kinds[i]);
+  }
+  add_row("total", stats.Total());
+  vector<int> data_width;
+  for (size_t i = 0; i < header.size(); i++) {
+    int width = header[i].length();
+    for (const auto &row : rows) {
+      width = max(width, int(row[i].length()));
+    }
+    data_width.push_back(width);
+  }
+  std::stringstream ss;
+  ResultWriter writer(ss);
+  writer.Divider(data_width);
+  writer.BeginRow();
+  for (size_t i = 0; i < header.size(); i++) {
+    writer.WriteHeaderCell(header[i], data_width[i]);
+  }
+  writer.EndRow();
+  writer.Divider(data_width);
+  for (const auto &row : rows) {
+    writer.BeginRow();
+    for (size_t i = 0; i < row.size(); i++) {
+      writer.WriteCell(row[i], data_width[i]);
+    }
+    writer.EndRow();
+  }
+  writer.Divider(data_width);
+  ss << "Pool size: " << bpm->GetPoolSize() << " frames" << endl;
+  ss << "Failed victim searches: " << stats.failed_victim_searches << endl;
+  ss << "Pin waits: " << stats.pin_waits << " (" << fixed << setprecision(3) << stats.pin_wait_ns / 1e6 << " ms)"
+     << endl;
+  DiskManager *disk_mgr = dbs_[current_db_]->disk_mgr_;
+  if (disk_mgr->IsCompressed()) {
+    // 字节数除以纳秒数再乘1000即MB/s
+    DiskCompressionStats compression = disk_mgr->GetCompressionStats();
+    double compress_speed = compression.compress_ns == 0 ? 0 : 1e3 * compression.bytes_in / compression.compress_ns;
+    double decompress_speed = compression.decompress_ns == 0
+                                  ? 0
+                                  : 1e3 * compression.pages_decompressed * PAGE_SIZE / compression.decompress_ns;
+    ss << "Page compression: ratio " << setprecision(2) << compression.Ratio() << ", " << compression.pages_compressed
+       << " pages compressed, " << compression.pages_stored_raw << " stored raw, " << setprecision(0)
+       << compress_speed << " MB/s compressing, " << decompress_speed << " MB/s decompressing" << endl;
+    ss << "Bytes read by page reads: " << compression.bytes_read << " (" << compression.device_bytes_read
+       << " from the device)" << endl;
+  }
+  cout << ss.str();
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteSetVariable(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteSetVariable" << std::endl;
+#endif
+  if (current_db_.empty()) {
+    cout << "No database selected" << endl;
+    return DB_FAILED;
+  }
+  string name = ast->child_->val_;
+  string value = ast->child_->next_->val_;
+  if (name != "buffer_pool_size") {
+    cout << "Unknown variable '" << name << "'" << endl;
+    return DB_FAILED;
+  }
+  BufferPoolManager *bpm = dbs_[current_db_]->bpm_;
+  // 只接受正整数
+  if (value.empty() || value.find_first_not_of("0123456789") != string::npos || value.size() > 9 ||
+      !bpm->Resize(stoul(value))) {
+    cout << "Cannot resize the buffer pool to " << value << " frames, the maximum is " << bpm->GetMaxPoolSize() << endl;
+    return DB_FAILED;
+  }
+  cout << "Buffer pool resized to " << bpm->GetPoolSize() << " frames" << endl;
+  return DB_SUCCESS;
+}
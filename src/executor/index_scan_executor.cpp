@@ -13,6 +13,10 @@ void IndexScanExecutor::Init() {
   auto first_row = table_info_->GetTableHeap()->Begin(nullptr);
   result_ = IndexScan(plan_->GetPredicate());
   is_schema_same_ = SchemaEqual(table_info_->GetSchema(), plan_->OutputSchema());
+  column_ids_.clear();
+  for (const auto column : plan_->OutputSchema()->GetColumns()) {
+    column_ids_.push_back(column->GetTableInd());
+  }
 }
 
 bool IndexScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *output_schema) {
@@ -32,18 +36,6 @@ bool IndexScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *ou
   return true;
 }
 
-void IndexScanExecutor::TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row,
-                                      Row *output_row) {
-  const auto &output_columns = output_schema->GetColumns();
-  std::vector<Field> dest_row;
-  dest_row.reserve(output_columns.size());
-  for (const auto column : output_columns) {
-    auto idx = column->GetTableInd();
-    dest_row.emplace_back(*row->GetField(idx));
-  }
-  *output_row = Row(dest_row);
-}
-
 vector<RowId> IndexScanExecutor::IndexScan(AbstractExpressionRef predicate) {
   switch (predicate->GetType()) {
     case ExpressionType::LogicExpression: {
@@ -78,24 +70,26 @@ vector<RowId> IndexScanExecutor::IndexScan(AbstractExpressionRef predicate) {
 
 bool IndexScanExecutor::Next(Row *row, RowId *rid) {
   auto predicate = plan_->GetPredicate();
-  auto table_schema = table_info_->GetSchema();
+  auto table_heap = table_info_->GetTableHeap();
   while (cursor_ < result_.size()) {
-    auto p_row = new Row(result_[cursor_]);
-    table_info_->GetTableHeap()->GetTuple(p_row, nullptr);
-    if (plan_->need_filter_) {
-      if (!predicate->Evaluate(p_row).CompareEquals(Field(kTypeInt, 1))) {
-        cursor_++;
-        continue;
+    RowId cur_rid = result_[cursor_++];
+    bool qualified = false;
+    // 与顺序扫描一样在page中求值谓词，只为满足条件的行构造Row
+    table_heap->VisitTuple(cur_rid, exec_ctx_->GetTransaction(), [&](const RowView &view) {
+      if (plan_->need_filter_ && !predicate->Evaluate(view).CompareEquals(Field(kTypeInt, 1))) {
+        return;
       }
+      qualified = true;
+      if (is_schema_same_) {
+        view.Materialize(row);
+      } else {
+        view.Materialize(row, column_ids_);
+      }
+    });
+    if (qualified) {
+      *rid = cur_rid;
+      return true;
     }
-    *rid = result_[cursor_];
-    if (!is_schema_same_) {
-      TupleTransfer(table_schema, plan_->OutputSchema(), p_row, row);
-    } else {
-      *row = *p_row;
-    }
-    cursor_++;
-    return true;
   }
   return false;
 }
@@ -16,11 +16,14 @@ void InsertExecutor::Init() {
 }
 
 bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-    Row insert_row;
+    // 插入的行和键写入page后就不再使用
+    MemHeap *heap = exec_ctx_->GetTupleMemHeap();
+    if (heap != nullptr) heap->Reset();
+    Row insert_row(heap);
     RowId insert_rid;
     if (child_executor_->Next(&insert_row, &insert_rid)) {
         for (auto info: index_info_) {
-            Row key_row;
+            Row key_row(heap);
             insert_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
             std::vector<RowId> result;
             if (!key_row.GetFields().empty() &&
@@ -30,7 +33,7 @@ bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
             }
         }
         if (table_info_->GetTableHeap()->InsertTuple(insert_row, exec_ctx_->GetTransaction())) {
-            Row key_row;
+            Row key_row(heap);
             for (auto info: index_info_) {  // 更新索引
                 insert_row.GetKeyFromRow(schema_, info->GetIndexKeySchema(), key_row);
                 info->GetIndex()->InsertEntry(key_row, insert_row.GetRowId(), exec_ctx_->GetTransaction());
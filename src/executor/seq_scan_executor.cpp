@@ -26,45 +26,40 @@ bool SeqScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *outp
   return true;
 }
 
-void SeqScanExecutor::TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row,
-                                    Row *output_row) {
-  const auto &output_columns = output_schema->GetColumns();
-  std::vector<Field> dest_row;
-  dest_row.reserve(output_columns.size());
-  for (const auto column : output_columns) {
-    auto idx = column->GetTableInd();
-    dest_row.emplace_back(*row->GetField(idx));
-  }
-  *output_row = Row(dest_row);
-}
-
 void SeqScanExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info_);
-  auto first_row = table_info_->GetTableHeap()->Begin(nullptr);
-  iterator_ = (table_info_->GetTableHeap()->Begin(exec_ctx_->GetTransaction()));
+  iterator_ = (table_info_->GetTableHeap()->Begin(exec_ctx_->GetTransaction(), true));
   schema_ = plan_->OutputSchema();
   is_schema_same_ = SchemaEqual(table_info_->GetSchema(), schema_);
+  column_ids_.clear();
+  for (const auto column : schema_->GetColumns()) {
+    column_ids_.push_back(column->GetTableInd());
+  }
 }
 
 bool SeqScanExecutor::Next(Row *row, RowId *rid) {
   auto predicate = plan_->GetPredicate();
-  auto table_schema = table_info_->GetSchema();
-  while (iterator_ != table_info_->GetTableHeap()->End()) {
-    auto p_row = &(*iterator_);
-    if (predicate != nullptr) {
-      if (!predicate->Evaluate(p_row).CompareEquals(Field(kTypeInt, 1))) {
-        iterator_++;
-        continue;
+  auto table_heap = table_info_->GetTableHeap();
+  while (iterator_ != table_heap->End()) {
+    RowId cur_rid = iterator_.GetRowId();
+    bool qualified = false;
+    // 谓词直接在page中的元组上求值，只为满足条件的行构造Row
+    table_heap->VisitTuple(cur_rid, exec_ctx_->GetTransaction(), [&](const RowView &view) {
+      if (predicate != nullptr && !predicate->Evaluate(view).CompareEquals(Field(kTypeInt, 1))) {
+        return;
       }
+      qualified = true;
+      if (is_schema_same_) {
+        view.Materialize(row);
+      } else {
+        view.Materialize(row, column_ids_);
+      }
+    });
+    ++iterator_;
+    if (qualified) {
+      *rid = cur_rid;
+      return true;
     }
-    *rid = iterator_->GetRowId();
-    if (!is_schema_same_) {
-      TupleTransfer(table_schema, schema_, p_row, row);
-    } else {
-      *row = *p_row;
-    }
-    iterator_++;
-    return true;
   }
   return false;
 }
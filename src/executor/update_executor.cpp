@@ -16,15 +16,19 @@ void UpdateExecutor::Init() {
 }
 
 bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-  Row src_row;
+  // 这些行只在处理当前元组时使用，上一个元组的行已经析构
+  MemHeap *heap = exec_ctx_->GetTupleMemHeap();
+  if (heap != nullptr) heap->Reset();
+  Row src_row(heap);
   RowId src_rid;
   if (child_executor_->Next(&src_row, &src_rid)) {
-    Row dest_row = GenerateUpdatedTuple(src_row);
+    Row dest_row(heap);
+    GenerateUpdatedTuple(src_row, &dest_row);
     if (!table_info_->GetTableHeap()->UpdateTuple(dest_row, src_rid, txn_)) {
       return false;
     }
-    Row src_key_row;
-    Row dest_key_row;
+    Row src_key_row(heap);
+    Row dest_key_row(heap);
     for (auto info : index_info_) {  // 更新索引
       src_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), src_key_row);
       dest_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), dest_key_row);
@@ -36,18 +40,17 @@ bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
   return false;
 }
 
-Row UpdateExecutor::GenerateUpdatedTuple(const Row &src_row) {
-  const auto update_attrs = plan_->GetUpdateAttr();
+void UpdateExecutor::GenerateUpdatedTuple(const Row &src_row, Row *dest_row) {
+  const auto &update_attrs = plan_->GetUpdateAttr();
   Schema *schema = table_info_->GetSchema();
   uint32_t col_count = schema->GetColumnCount();
-  std::vector<Field> values;
+  dest_row->destroy();
   for (uint32_t idx = 0; idx < col_count; idx++) {
-    if (update_attrs.find(idx) == update_attrs.cend()) {
-      values.emplace_back(*src_row.GetField(idx));
+    auto iter = update_attrs.find(idx);
+    if (iter == update_attrs.cend()) {
+      dest_row->AppendField(*src_row.GetField(idx));
     } else {
-      auto expr = update_attrs.at(idx);
-      values.emplace_back(expr->Evaluate(&src_row));
+      dest_row->AppendField(iter->second->Evaluate(&src_row));
     }
   }
-  return Row{values};
 }
\ No newline at end of file
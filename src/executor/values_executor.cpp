@@ -13,12 +13,11 @@ void ValuesExecutor::Init() {
 
 bool ValuesExecutor::Next(Row *row, RowId *rid) {
   if (cursor_ < value_size_) {
-    std::vector<Field> values;
-    auto exprs = plan_->GetValues().at(cursor_);
-    for (auto expr : exprs) {
-      values.emplace_back(expr->Evaluate(nullptr));
+    row->destroy();
+    row->SetRowId(RowId());
+    for (const auto &expr : plan_->GetValues().at(cursor_)) {
+      row->AppendField(expr->Evaluate(nullptr));
     }
-    *row = Row{values};
     cursor_++;
     return true;
   }
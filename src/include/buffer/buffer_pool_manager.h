@@ -1,58 +1,462 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <list>
+#include <memory>
 #include <mutex>
-#include <unordered_map>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
+#include "buffer/buffer_ring.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/frame_arena.h"
+#include "buffer/lru_k_replacer.h"
 #include "buffer/lru_replacer.h"
+#include "buffer/page_access_trace.h"
+#include "buffer/page_table.h"
+#include "buffer/prefetcher.h"
 #include "page/disk_file_meta_page.h"
 #include "page/page.h"
 #include "storage/disk_manager.h"
 
 using namespace std;
 
+/**
+ * Counters of the background writer, and of the writes the foreground still had to do itself or wait for.
+ */
+struct BufferWriterStats {
+  uint64_t bg_pages_written{0};  // dirty pages cleaned by the background writer
+  uint64_t bg_writes{0};         // disk writes it issued, adjacent pages being merged into one write
+  uint64_t evictions{0};         // victims taken from the replacer or recycled by a buffer ring
+  uint64_t fg_victim_writes{0};  // evictions which had to write a dirty victim back in the foreground
+  uint64_t fg_write_waits{0};    // foreground reads or writes which waited for a background write of the same page
+};
+
+/**
+ * Counters of the accesses to the pages of one kind.
+ */
+struct BufferKindStats {
+  uint64_t hits{0};              // fetches of a resident page
+  uint64_t misses{0};            // fetches which had to read the page from disk
+  uint64_t evictions{0};         // pages of this kind whose frame was taken for another page
+  uint64_t dirty_writebacks{0};  // dirty pages written back, by an eviction, FlushPage() or the background writer
+};
+
+/**
+ * Statistics of a buffer pool, see BufferPoolManager::GetBufferStats().
+ */
+struct BufferPoolStats {
+  BufferKindStats kinds[NUM_PAGE_KINDS];  // indexed by PageKind
+  uint64_t failed_victim_searches{0};     // fetches and allocations which returned nullptr as every frame was pinned
+  uint64_t pin_waits{0};                  // fetches and allocations which blocked on the latch or on another's I/O
+  uint64_t pin_wait_ns{0};                // time they spent blocked
+
+  /** @return the counters summed over every kind */
+  BufferKindStats Total() const;
+
+  /** Add the counters of other to these ones. */
+  void Merge(const BufferPoolStats &other);
+};
+
+/**
+ * BufferPoolManager caches disk pages in a number of in-memory frames which can be changed online by Resize(), up
+ * to the capacity given at construction.
+ *
+ * The frames live in a page-aligned FrameArena backed by huge pages when possible, apart from the dense array of
+ * their descriptors (pages_), so that walking the descriptors touches neither the frames nor their TLB entries.
+ *
+ * All public methods are thread safe: every instance serializes its bookkeeping with its own latch. The public
+ * interface is virtual so that ParallelBufferPoolManager can be used wherever a BufferPoolManager is expected.
+ *
+ * Over a read-only disk manager (DiskIOBackend::kMmap) there are no frames at all: FetchPage() hands out pages whose
+ * data is the mapping of the db file, without any copy nor bound on the number of pages pinned at once, and whatever
+ * would allocate, dirty or write a page fails. The mapping is read-only, so writing into such a page faults: the table
+ * heaps, indexes and catalog check IsReadOnly() and refuse to modify anything before touching a page.
+ */
 class BufferPoolManager {
+  friend class BufferRing;
+  friend class ParallelBufferPoolManager;
+  friend class Prefetcher;
+
  public:
-  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
+  /**
+   * @param pool_size number of frames
+   * @param disk_manager the disk manager pages are read from and written to
+   * @param replacer_type replacement policy used to pick a victim when no frame is free
+   * @param max_pool_size number of frames the pool may grow to, pool_size if it is smaller
+   */
+  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager,
+                             ReplacerType replacer_type = ReplacerType::kLRU, size_t max_pool_size = 0);
+
+  virtual ~BufferPoolManager();
+
+  virtual Page *FetchPage(page_id_t page_id);
+
+  /**
+   * Fetch a page with a bulk read access strategy: on a miss the page is read into a frame of the ring rather than
+   * one taken from the main replacer.
+   * @param ring ring created by NewBufferRing() on this buffer pool, nullptr for a normal fetch
+   */
+  virtual Page *FetchPage(page_id_t page_id, BufferRing *ring);
+
+  /**
+   * Create a private ring of frames for a scan, see BufferRing.
+   * @param ring_size number of frames the ring may hold
+   */
+  virtual std::unique_ptr<BufferRing> NewBufferRing(size_t ring_size = DEFAULT_BUFFER_RING_SIZE);
+
+  /**
+   * Pin a page only if it is resident and its content is readable, without doing or waiting for any I/O.
+   * @return the pinned page, nullptr otherwise
+   */
+  virtual Page *TryFetchPage(page_id_t page_id);
+
+  /**
+   * Tell whether a page is resident and readable without taking the latch. The answer may be stale by the time the
+   * caller acts on it, it is only meant to avoid a pointless TryFetchPage().
+   */
+  virtual bool IsPageReady(page_id_t page_id);
+
+  /**
+   * Ask the I/O threads to read pages a scan is about to fetch. Pages which are resident or already being read are
+   * skipped, and a page which cannot get a frame is simply not read. This is a hint: nothing happens unless the
+   * prefetcher has been started.
+   * @param ring buffer ring of the scan, nullptr to read the pages into the main pool
+   */
+  virtual void PrefetchPages(const std::vector<page_id_t> &page_ids, BufferRing *ring = nullptr);
+
+  /**
+   * Start the I/O threads serving PrefetchPages(). Must not race with PrefetchPages() nor with StopPrefetcher().
+   */
+  void StartPrefetcher(size_t num_threads = DEFAULT_PREFETCH_THREADS);
+
+  /**
+   * Stop the I/O threads, dropping the requests which have not started. Called by the destructor.
+   */
+  void StopPrefetcher();
+
+  /** @return true if PrefetchPages() reads anything */
+  inline bool IsPrefetching() const { return prefetcher_ != nullptr; }
+
+  /**
+   * Record the page id of every FetchPage(), and of every TryFetchPage() which pins a page, into trace. Reads ahead
+   * and NewPage() are not accesses of the workload and are left out.
+   * @param trace the trace to record into, nullptr to stop recording
+   */
+  virtual void SetAccessTrace(PageAccessTrace *trace);
 
-  ~BufferPoolManager();
+  /** @return the ids of the resident pages, the most recently pinned first */
+  std::vector<page_id_t> GetResidentPages();
 
-  Page *FetchPage(page_id_t page_id);
+  /**
+   * Write GetResidentPages() to file_name, one page id per line, so that WarmUp() can reload them after a restart.
+   * The list goes to a temporary file which is then renamed over file_name.
+   * @return false if the file cannot be written
+   */
+  bool SaveResidentPages(const std::string &file_name);
+
+  /**
+   * Ask the prefetcher to read the pages listed in file_name by SaveResidentPages(), in physical order. Only the
+   * GetPoolSize() most recent of them are read, so that the warm-up does not evict the pages it has just read. Nothing
+   * happens unless the prefetcher has been started.
+   * @return the number of pages requested, 0 if the file cannot be read
+   */
+  size_t WarmUp(const std::string &file_name);
 
-  bool UnpinPage(page_id_t page_id, bool is_dirty);
+  /**
+   * @return false if the page is not pinned, or if it is dirtied in a read-only pool, where it is unpinned all the same
+   */
+  virtual bool UnpinPage(page_id_t page_id, bool is_dirty);
 
-  bool FlushPage(page_id_t page_id);
+  virtual bool FlushPage(page_id_t page_id);
 
-  Page *NewPage(page_id_t &page_id);
+  virtual Page *NewPage(page_id_t &page_id);
 
-  bool DeletePage(page_id_t page_id);
+  /**
+   * Create num_pages pinned pages for a bulk writer. Their ids are consecutive, and so are their pages on disk, when
+   * an extent has a long enough run of free pages; otherwise they are allocated one at a time like NewPage().
+   * @return the pages in id order, empty if they cannot all be created
+   */
+  virtual std::vector<Page *> NewPages(size_t num_pages);
+
+  virtual bool DeletePage(page_id_t page_id);
 
   bool IsPageFree(page_id_t page_id);
 
-  bool CheckAllUnpinned();
+  virtual bool CheckAllUnpinned();
+
+  /** @return the number of frames managed by this buffer pool */
+  virtual size_t GetPoolSize() { return pool_size_; }
+
+  /** @return true if the pages are used in place from a read-only mapping and must not be modified */
+  inline bool IsReadOnly() const { return read_only_; }
+
+  /** @return the number of frames the buffer pool may grow to */
+  virtual size_t GetMaxPoolSize() { return max_pool_size_; }
+
+  /**
+   * Change the number of frames online. Growing hands out new frames of the reserved capacity. Shrinking takes the
+   * highest frames out of the pool: an unpinned one is written back if dirty and its memory is given back at once,
+   * a pinned one stays valid until its last unpin, so pages held by callers are never invalidated.
+   * @return false if pool_size is 0, exceeds GetMaxPoolSize() or the pool is read-only
+   */
+  virtual bool Resize(size_t pool_size);
+
+  /**
+   * Start a thread which writes dirty unpinned pages back ahead of time, so that at least clean_ratio of the frames
+   * are free or clean when the foreground needs a victim. Each round writes at most BG_WRITER_MAX_PAGES pages through
+   * DiskManager::WritePages, in physical order and merging adjacent pages.
+   */
+  void StartBackgroundWriter(double clean_ratio = DEFAULT_BG_WRITER_CLEAN_RATIO);
+
+  /**
+   * Stop the background writer, if it is running. Called by the destructor.
+   */
+  void StopBackgroundWriter();
+
+  /** @return counters of the background writer and of foreground writes */
+  virtual BufferWriterStats GetWriterStats();
+
+  /**
+   * @return the counters of hits, misses, evictions and write-backs by page kind, and of fetches which failed or
+   * waited. Every counter is read on its own, so they may be slightly inconsistent with each other while the pool is
+   * in use.
+   */
+  virtual BufferPoolStats GetBufferStats();
+
+  /**
+   * Tell what a page holds from its content: the fixed catalog pages and the metadata pages by their id or magic
+   * number, B+ tree pages by their type and the page id they store, table pages by the page id at their start. A
+   * page which matches nothing, such as a new page not initialized yet, is kOther.
+   */
+  static PageKind ClassifyPage(page_id_t page_id, const char *data);
+
+  /** @return how the memory of the frames is backed */
+  virtual FrameArenaBacking GetFrameBacking() { return frames_.GetBacking(); }
+
+ protected:
+  /**
+   * Create a buffer pool without any frame of its own, used by subclasses which keep their frames elsewhere.
+   */
+  explicit BufferPoolManager(DiskManager *disk_manager);
 
- private:
   /**
    * Allocate new page (operations like create index/table) For now just keep an increasing counter
    */
   page_id_t AllocatePage();
 
+  /**
+   * Allocate num_pages consecutive pages inside one extent, see DiskManager::AllocatePages().
+   */
+  page_id_t AllocatePages(size_t num_pages);
+
   /**
    * Deallocate page (operations like drop index/table) Need bitmap in header page for tracking pages
    */
   void DeallocatePage(page_id_t page_id);
 
-  frame_id_t TryToFindFreePage();
+ private:
+  /**
+   * A dirty page copied out of its frame by the background writer.
+   */
+  struct DirtyPage {
+    page_id_t page_id;
+    BufferPoolManager *owner;  // the buffer pool the page was copied from
+    const char *data;
+  };
+
+  /**
+   * Copy dirty unpinned pages to staging, mark them clean and register them as being written, until clean_ratio of
+   * the frames are free or clean or dirty_pages holds max_pages pages. The i-th page of dirty_pages is copied to
+   * staging + i * PAGE_SIZE.
+   * @return the number of pages appended to dirty_pages
+   */
+  virtual size_t CollectDirtyPages(double clean_ratio, char *staging, size_t max_pages,
+                                   vector<DirtyPage> &dirty_pages);
+
+  /**
+   * Mark the background write of a page as done and wake up the threads waiting for it.
+   */
+  void FinishBackgroundWrite(page_id_t page_id);
+
+  /**
+   * Block until no background write of page_id is in flight, so that the foreground never reads a page before its
+   * latest version reached the disk nor overwrites a newer version with an older one.
+   */
+  void WaitForBackgroundWrite(page_id_t page_id);
+
+  void BackgroundWriterLoop(double clean_ratio);
+
+  /**
+   * Append every resident page with the time it was last pinned to resident_pages.
+   */
+  virtual void CollectResidentPages(vector<pair<int64_t, page_id_t>> &resident_pages);
+
+  /** Append an access to the trace set by SetAccessTrace(), if any. */
+  inline void RecordAccess(page_id_t page_id) {
+    PageAccessTrace *trace = access_trace_.load(std::memory_order_relaxed);
+    if (trace != nullptr) trace->Record(page_id);
+  }
+
+  /** Record that a page is being pinned. */
+  static inline void TouchPage(Page &page) {
+    page.last_used_ = std::chrono::steady_clock::now().time_since_epoch().count();
+  }
+
+  /**
+   * Read a page into a frame for the prefetcher. The frame stays pinned and marked as being read while the read runs
+   * without the latch, so that FetchPage() of the same page waits for it instead of reading it a second time.
+   * @return true if the page was read
+   */
+  bool PrefetchPage(page_id_t page_id, BufferRing *ring);
+
+  /**
+   * Wait until the read of a pinned frame by the prefetcher is complete. Must be called without latch_ held.
+   */
+  void WaitForRead(frame_id_t frame_id);
+
+  /**
+   * Ask the background writer to start its next round now, called when the foreground had to write a victim.
+   */
+  void WakeBackgroundWriter();
+
+  /**
+   * Bring a page whose id has already been allocated on disk into a zeroed frame.
+   * @return the pinned page, nullptr if every frame is pinned
+   */
+  virtual Page *NewPageWithId(page_id_t page_id);
+
+  /**
+   * Pick a frame from the free list first, then from the replacer. A dirty victim is written back and removed
+   * from the page table. Must be called with latch_ held.
+   * @return true if a frame was found
+   */
+  bool TryToFindFreeFrame(frame_id_t &frame_id);
+
+  /**
+   * Pick the frame a ring reads its next page into. The frame in the ring's next slot is recycled if the ring still
+   * owns it and nobody pins it, otherwise a frame is taken by TryToFindFreeFrame() and joins the ring. Must be called
+   * with latch_ held.
+   * @return true if a frame was found
+   */
+  bool TryToFindRingFrame(BufferRing *ring, frame_id_t &frame_id);
+
+  /**
+   * Hand the frames of a ring which is being destroyed back to the main replacer.
+   */
+  void ReleaseBufferRing(BufferRing *ring);
+
+  /**
+   * Pin the descriptor of a page of a read-only buffer pool, pointing it to the mapping of the page.
+   * @return nullptr if the db file does not hold the page
+   */
+  Page *FetchMappedPage(page_id_t page_id);
+
+  /**
+   * @return the descriptor of a page of a read-only buffer pool, nullptr if the page has never been fetched
+   */
+  Page *FindMappedPage(page_id_t page_id);
+
+  /**
+   * Pin a resident page which somebody else already pins, without the latch. A pinned frame is neither evicted nor
+   * given another page, so once the pin count is raised from above zero the frame can be checked to still hold
+   * page_id. Pages nobody pins are left to FetchPage() under the latch, because pinning them takes them out of the
+   * replacer.
+   * @return the page, or nullptr if page_id is not resident, not pinned or still being read by the prefetcher
+   */
+  Page *TryPinPinnedPage(page_id_t page_id);
+
+  /** Drop a pin taken by TryPinPinnedPage() on a frame which turned out not to hold the page. */
+  void UndoPin(frame_id_t frame_id);
+
+  /**
+   * Take a frame beyond pool_size_ out of the pool once nobody pins it: write it back if dirty, drop its page and give
+   * its memory back. Must be called with latch_ held.
+   */
+  void RetireFrame(frame_id_t frame_id);
+
+  /**
+   * Construct num_pages page descriptors in a single cache-line aligned allocation, the i-th one pointing to
+   * data + i * PAGE_SIZE, or to no data if data is nullptr.
+   */
+  static Page *NewDescriptors(size_t num_pages, char *data);
+
+  /**
+   * Allocate room for num_pages page descriptors without constructing them. The memory is committed as the
+   * descriptors are constructed, so a large capacity costs nothing until the pool grows.
+   */
+  static Page *AllocateDescriptors(size_t num_pages);
+
+  /**
+   * Construct the descriptors [from, to) of pages, the i-th one pointing to data + i * PAGE_SIZE.
+   */
+  static void ConstructDescriptors(Page *pages, size_t from, size_t to, char *data);
+
+  static void DeleteDescriptors(Page *pages, size_t num_pages);
+
+  /**
+   * Take latch_ for a call which pins a page, accounting the time it waited if the latch was contended.
+   */
+  std::unique_lock<std::recursive_mutex> LockForPin();
+
+  void RecordPinWait(std::chrono::steady_clock::time_point start);
+
+  /**
+   * Counters of the accesses to the pages of one kind.
+   */
+  struct KindCounters {
+    atomic<uint64_t> hits{0};
+    atomic<uint64_t> misses{0};
+    atomic<uint64_t> evictions{0};
+    atomic<uint64_t> dirty_writebacks{0};
+  };
+
+  inline KindCounters &CountersOf(const Page &page) { return kind_counters_[static_cast<size_t>(page.kind_.load())]; }
+
+  static constexpr size_t MAPPED_PAGES_PER_CHUNK = 1024;
 
  private:
-  size_t pool_size_;                                 // number of pages in buffer pool
-  Page *pages_;                                      // array of pages
+  bool read_only_;                                   // pages are handed out in place from a read-only mapping
+  atomic<size_t> pool_size_;                         // number of pages in buffer pool
+  size_t max_pool_size_;                             // capacity reserved for frames, pool_size_ never exceeds it
+  FrameArena frames_;                                // data of the frames, PAGE_SIZE bytes each
+  Page *pages_;                                      // descriptors of the frames, room for max_pool_size_ of them
+  size_t num_constructed_{0};                        // descriptors constructed so far, the pool has had as many frames
   DiskManager *disk_manager_;                        // pointer to the disk manager.
-  unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
+  PageTable page_table_;                             // to keep track of pages
   Replacer *replacer_;                               // to find an unpinned page for replacement
+  vector<BufferRing *> ring_owner_;                  // ring each frame belongs to, nullptr for the main pool
   list<frame_id_t> free_list_;                       // to find a free page for replacement
   recursive_mutex latch_;                            // to protect shared data structure
+
+  thread bg_writer_;                                 // background writer thread, if started
+  mutex bg_writer_latch_;                            // protects bg_writer_running_
+  condition_variable bg_writer_cv_;                  // to stop the background writer while it is idle
+  bool bg_writer_running_{false};
+  atomic<bool> bg_writer_wakeup_{false};
+  BufferPoolManager *bg_writer_host_{this};          // the pool running the background writer, the parent for a shard
+  mutex io_latch_;                                   // protects flushing_ and the reading_ flags being cleared
+  condition_variable io_cv_;                         // signalled when a background write or a read ahead finishes
+  unordered_set<page_id_t> flushing_;                // pages whose background write is in flight
+  unique_ptr<atomic<bool>[]> reading_;               // frames being filled by the prefetcher
+  unique_ptr<Prefetcher> prefetcher_;                // I/O threads serving PrefetchPages(), if started
+  vector<Page *> mapped_pages_;                      // descriptors of the pages of a read-only pool, by page id
+  atomic<PageAccessTrace *> access_trace_{nullptr};   // where FetchPage() records its accesses, if anywhere
+
+  atomic<uint64_t> bg_pages_written_{0};
+  atomic<uint64_t> bg_writes_{0};
+  atomic<uint64_t> evictions_{0};
+  atomic<uint64_t> fg_victim_writes_{0};
+  atomic<uint64_t> fg_write_waits_{0};
+  KindCounters kind_counters_[NUM_PAGE_KINDS];
+  atomic<uint64_t> failed_victim_searches_{0};
+  atomic<uint64_t> pin_waits_{0};
+  atomic<uint64_t> pin_wait_ns_{0};
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
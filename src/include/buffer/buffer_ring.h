@@ -0,0 +1,58 @@
+#ifndef MINISQL_BUFFER_RING_H
+#define MINISQL_BUFFER_RING_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+class BufferPoolManager;
+
+/**
+ * BufferRing is the access strategy of a bulk read such as a sequential scan.
+ *
+ * A page fetched through a ring which is not already resident is read into one of a small set of frames private to
+ * the ring, recycled round robin, instead of a frame taken from the main replacer. Those frames never enter the main
+ * replacer while the ring is alive, so a scan over a large table cannot push the working set of other queries out of
+ * the pool. Pages which are already resident are used in place.
+ *
+ * A ring is obtained from BufferPoolManager::NewBufferRing(), is used by one scan at a time and must be destroyed
+ * before its buffer pool. When it is destroyed it waits for the read-ahead requests which refer to it, then hands its
+ * frames back to the main replacer.
+ */
+class BufferRing {
+  friend class BufferPoolManager;
+  friend class ParallelBufferPoolManager;
+  friend class Prefetcher;
+
+ public:
+  ~BufferRing();
+
+  DISALLOW_COPY(BufferRing);
+
+  /** @return the number of frames the ring may hold */
+  inline size_t GetRingSize() const { return ring_size_; }
+
+ private:
+  BufferRing(BufferPoolManager *bpm, size_t ring_size) : bpm_(bpm), ring_size_(ring_size) {}
+
+  /** Count a read-ahead request which refers to the ring */
+  void BeginPrefetch();
+
+  /** A read-ahead request which refers to the ring is done or dropped */
+  void EndPrefetch();
+
+  BufferPoolManager *bpm_;                    // the pool whose frames are recycled
+  size_t ring_size_;
+  std::vector<frame_id_t> frames_;            // frames taken so far, at most ring_size_
+  size_t next_{0};                            // next slot of frames_ to recycle
+  std::vector<std::unique_ptr<BufferRing>> shards_;  // one ring per instance of a parallel buffer pool
+  std::mutex prefetch_latch_;
+  std::condition_variable prefetch_cv_;
+  size_t pending_prefetches_{0};              // read-ahead requests queued or running for this ring
+};
+
+#endif  // MINISQL_BUFFER_RING_H
@@ -1,12 +1,6 @@
 #ifndef MINISQL_CLOCK_REPLACER_H
 #define MINISQL_CLOCK_REPLACER_H
 
-#include <algorithm>
-#include <list>
-#include <map>
-#include <mutex>
-#include <queue>
-#include <unordered_set>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -16,6 +10,10 @@ using namespace std;
 
 /**
  * CLOCKReplacer implements the clock replacement.
+ *
+ * The clock is the array of frames itself: the hand sweeps the frame ids in order, skipping the frames which are not
+ * evictable, and gives a frame whose reference bit is set a second chance. Pin() and Unpin() are O(1), Victim() is
+ * O(1) amortized, and nothing is allocated once the replacer has been constructed.
  */
 class CLOCKReplacer : public Replacer {
  public:
@@ -36,12 +34,16 @@ class CLOCKReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void SetCapacity(size_t num_pages) override;
+
   size_t Size() override;
 
  private:
-  size_t capacity;
-  list<frame_id_t> clock_list;               // replacer中可以被替换的数据页
-  map<frame_id_t, frame_id_t> clock_status;  // 数据页的存储状态
+  size_t capacity_;                  // 最多可以容纳的页数
+  size_t size_{0};                   // 可以被替换的页数
+  size_t hand_{0};                   // 时钟指针，指向下一个被检查的帧
+  vector<bool> evictable_;           // 帧是否在replacer中
+  vector<bool> referenced_;          // 帧的引用位
 };
 
-#endif  // MINISQL_CLOCK_REPLACER_H
\ No newline at end of file
+#endif  // MINISQL_CLOCK_REPLACER_H
@@ -0,0 +1,67 @@
+#ifndef MINISQL_FRAME_ARENA_H
+#define MINISQL_FRAME_ARENA_H
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * How the memory of a FrameArena is backed.
+ */
+enum class FrameArenaBacking {
+  kNone,             // the arena holds no frame
+  kRegularPages,     // anonymous mapping of base pages
+  kTransparentHuge,  // anonymous mapping aligned to HUGE_PAGE_SIZE and advised to use transparent huge pages
+  kHugeTLB,          // explicit huge pages from the hugetlb pool (MAP_HUGETLB)
+};
+
+/**
+ * FrameArena holds the data of the frames of a buffer pool in one contiguous, zeroed and page-aligned mapping.
+ * Being page-aligned, the frames can be read and written with direct I/O (DIRECT_IO_ALIGNMENT) as they are.
+ *
+ * An arena of at least HUGE_PAGE_SIZE bytes is first mapped with MAP_HUGETLB, which only works when huge pages have
+ * been reserved (vm.nr_hugepages). Otherwise it is mapped at a HUGE_PAGE_SIZE boundary and advised with
+ * MADV_HUGEPAGE, so that the kernel backs it with transparent huge pages when they are enabled. Either way a pool of
+ * DEFAULT_BUFFER_POOL_SIZE frames needs 40 TLB entries instead of 20480. Smaller arenas use base pages.
+ *
+ * An arena may reserve room for more frames than the pool uses now, so that the pool can grow in place. The room is
+ * only address space, the kernel commits memory to a frame when it is first touched and takes it back on Release().
+ * Such an arena never uses hugetlb pages, which are committed when they are mapped.
+ */
+class FrameArena {
+ public:
+  /**
+   * @param num_frames number of frames of PAGE_SIZE bytes, throws std::bad_alloc if they cannot be mapped
+   * @param max_frames number of frames to reserve room for, no less than num_frames
+   */
+  explicit FrameArena(size_t num_frames, size_t max_frames = 0);
+
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /** @return the data of a frame */
+  inline char *GetFrame(size_t frame_id) const { return data_ + frame_id * PAGE_SIZE; }
+
+  /** @return the data of the first frame, the frames follow each other */
+  inline char *GetData() const { return data_; }
+
+  /** @return the number of frames the arena has room for */
+  inline size_t GetNumFrames() const { return num_frames_; }
+
+  /**
+   * Give the memory of some frames back to the kernel. The frames stay usable, with unspecified content.
+   */
+  void Release(size_t first_frame, size_t num_frames);
+
+  inline FrameArenaBacking GetBacking() const { return backing_; }
+
+ private:
+  char *data_{nullptr};
+  size_t num_frames_;
+  size_t mapped_size_{0};  // bytes mapped, num_frames_ * PAGE_SIZE rounded up to the backing page size
+  FrameArenaBacking backing_{FrameArenaBacking::kNone};
+};
+
+#endif  // MINISQL_FRAME_ARENA_H
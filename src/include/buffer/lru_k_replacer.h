@@ -0,0 +1,70 @@
+#ifndef MINISQL_LRU_K_REPLACER_H
+#define MINISQL_LRU_K_REPLACER_H
+
+#include <deque>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * Every Pin() of a frame is an access. The victim is the evictable frame whose K-th most recent access lies furthest
+ * in the past (largest backward k-distance). Frames with fewer than K accesses have an infinite backward k-distance
+ * and are evicted first, least recently used among them first. A page touched once by a large scan therefore leaves
+ * before a page which has been used repeatedly, such as the upper levels of a B+ tree.
+ *
+ * Back-to-back accesses to the same frame (e.g. a table iterator fetching the same page once per tuple) are
+ * correlated and count as a single reference.
+ *
+ * History is kept per frame and is dropped when the frame is victimized or removed.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k number of accesses remembered for each frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  void SetCapacity(size_t num_pages) override;
+
+  size_t Size() override;
+
+ private:
+  using EvictKey = pair<uint64_t, frame_id_t>;
+
+  /** @return the key the frame is ordered by while it is evictable */
+  EvictKey KeyOf(frame_id_t frame_id) const;
+
+  void Evict(frame_id_t frame_id);
+
+  size_t k_;
+  uint64_t current_timestamp_{0};                 // logical clock, advanced on every non correlated access
+  frame_id_t last_accessed_{INVALID_FRAME_ID};    // frame of the latest access, to detect correlated accesses
+  vector<deque<uint64_t>> history_;               // at most k timestamps per frame, most recent at the back
+  vector<bool> evictable_;
+  set<EvictKey> cold_;                            // evictable frames with fewer than k accesses, by last access
+  set<EvictKey> hot_;                             // evictable frames with k accesses, by k-th most recent access
+};
+
+#endif  // MINISQL_LRU_K_REPLACER_H
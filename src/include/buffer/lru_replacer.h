@@ -1,9 +1,6 @@
 #ifndef MINISQL_LRU_REPLACER_H
 #define MINISQL_LRU_REPLACER_H
 
-#include <list>
-#include <mutex>
-#include <unordered_set>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -13,6 +10,9 @@ using namespace std;
 
 /**
  * LRUReplacer implements the Least Recently Used replacement policy.
+ *
+ * The evictable frames form a doubly linked list threaded through arrays indexed by frame id, so that every
+ * operation is O(1) and nothing is allocated once the replacer has been constructed.
  */
 class LRUReplacer : public Replacer {
  public:
@@ -33,14 +33,22 @@ class LRUReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void SetCapacity(size_t num_pages) override;
+
   size_t Size() override;
 
-private:
-  // add your own private member variables here
-   std::list<frame_id_t> lru_list;//用于存储被替换的页，如果为空则返回false
- std::vector<std::list<frame_id_t>::iterator> cache;
- size_t num_page;
- 
+ private:
+  void Link(frame_id_t frame_id);
+
+  void Unlink(frame_id_t frame_id);
+
+  size_t num_pages_;                     // 最多可以容纳的页数
+  size_t size_{0};                       // 链表中的页数
+  frame_id_t head_{INVALID_FRAME_ID};    // 最近被unpin的页
+  frame_id_t tail_{INVALID_FRAME_ID};    // 最久未被使用的页，下一个victim
+  vector<frame_id_t> prev_;              // 链表中更近使用的一页
+  vector<frame_id_t> next_;              // 链表中更久未使用的一页
+  vector<bool> linked_;                  // 页是否在链表中
 };
 
 #endif  // MINISQL_LRU_REPLACER_H
@@ -0,0 +1,40 @@
+#ifndef MINISQL_PAGE_ACCESS_TRACE_H
+#define MINISQL_PAGE_ACCESS_TRACE_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * PageAccessTrace records the page ids a buffer pool is asked for, see BufferPoolManager::SetAccessTrace(), so that
+ * real workloads can be replayed against every replacement policy offline. Recording is thread safe, the shards of a
+ * ParallelBufferPoolManager share one trace.
+ */
+class PageAccessTrace {
+ public:
+  /** Append an access to the trace. */
+  void Record(page_id_t page_id);
+
+  /** @return the accesses recorded so far, in order */
+  std::vector<page_id_t> GetPageIds();
+
+  /**
+   * Write the trace to file_name as raw page ids.
+   * @return false if the file cannot be written
+   */
+  bool Save(const std::string &file_name);
+
+  /**
+   * Read a trace written by Save().
+   * @return false if the file cannot be read
+   */
+  static bool Load(const std::string &file_name, std::vector<page_id_t> &page_ids);
+
+ private:
+  std::mutex latch_;
+  std::vector<page_id_t> page_ids_;
+};
+
+#endif  // MINISQL_PAGE_ACCESS_TRACE_H
@@ -0,0 +1,104 @@
+#ifndef MINISQL_PAGE_TABLE_H
+#define MINISQL_PAGE_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * PageTable maps resident page ids to frame ids for the buffer pool.
+ *
+ * It is a flat open-addressing hash table with linear probing, sized once from the pool size so that it is never
+ * more than half full. Each slot packs the page id and frame id into one 64-bit word, so a hit costs a single probe,
+ * never allocates, and a reader can never observe a torn entry.
+ *
+ * Find() takes no lock and may run concurrently with Insert()/Erase(). Writers must be serialized by the caller
+ * (the buffer pool latch). Erase() uses backward-shift deletion, so a concurrent Find() may miss a key while it is
+ * being moved; a miss must therefore be confirmed under the writers' latch before it is acted upon.
+ */
+class PageTable {
+ public:
+  /**
+   * @param num_frames the maximum number of entries the table has to hold
+   */
+  explicit PageTable(size_t num_frames);
+
+  ~PageTable() = default;
+
+  DISALLOW_COPY(PageTable);
+
+  /**
+   * Look up a page.
+   * @param page_id the page to look for
+   * @param[out] frame_id frame holding the page
+   * @return true if the page is resident
+   */
+  inline bool Find(page_id_t page_id, frame_id_t &frame_id) const {
+    for (size_t pos = Hash(page_id);; pos = (pos + 1) & mask_) {
+      uint64_t slot = slots_[pos].load(std::memory_order_acquire);
+      if (slot == EMPTY_SLOT) {
+        return false;
+      }
+      if (KeyOf(slot) == page_id) {
+        frame_id = ValueOf(slot);
+        return true;
+      }
+    }
+  }
+
+  /**
+   * Insert a page, or update the frame of a page already in the table.
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Remove a page.
+   * @return true if the page was in the table
+   */
+  bool Erase(page_id_t page_id);
+
+  /** @return the number of pages in the table */
+  inline size_t Size() const { return size_; }
+
+  /** @return the number of slots in the table */
+  inline size_t Capacity() const { return mask_ + 1; }
+
+  /**
+   * Call func(page_id, frame_id) for every entry. Must not run concurrently with writers.
+   */
+  template <typename Func>
+  void ForEach(Func &&func) const {
+    for (size_t i = 0; i <= mask_; i++) {
+      uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+      if (slot != EMPTY_SLOT) {
+        func(KeyOf(slot), ValueOf(slot));
+      }
+    }
+  }
+
+ private:
+  static constexpr uint64_t EMPTY_SLOT = ~0ULL;
+
+  static inline uint64_t MakeSlot(page_id_t page_id, frame_id_t frame_id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+
+  static inline page_id_t KeyOf(uint64_t slot) { return static_cast<page_id_t>(slot >> 32); }
+
+  static inline frame_id_t ValueOf(uint64_t slot) { return static_cast<frame_id_t>(slot & 0xFFFFFFFFULL); }
+
+  /** Fibonacci hashing: page ids are mostly dense, multiplying spreads neighbours over the table. */
+  inline size_t Hash(page_id_t page_id) const {
+    return static_cast<size_t>((static_cast<uint32_t>(page_id) * 2654435769U) >> shift_) & mask_;
+  }
+
+  size_t mask_;
+  uint32_t shift_;
+  size_t size_{0};
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+};
+
+#endif  // MINISQL_PAGE_TABLE_H
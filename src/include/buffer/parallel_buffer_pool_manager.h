@@ -0,0 +1,107 @@
+#ifndef MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+#define MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+
+/**
+ * ParallelBufferPoolManager spreads pages over several independent BufferPoolManager shards. A page always lives
+ * in shard (page_id % num_instances), and each shard has its own page table, free list, replacer and latch, so
+ * threads working on different pages rarely contend on the same lock.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @param num_instances number of shards
+   * @param pool_size total number of frames, split as evenly as possible between the shards
+   * @param disk_manager the disk manager shared by all shards
+   * @param replacer_type replacement policy of every shard
+   * @param max_pool_size total number of frames the pool may grow to, split like pool_size
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            ReplacerType replacer_type = ReplacerType::kLRU, size_t max_pool_size = 0);
+
+  ~ParallelBufferPoolManager() override;
+
+  Page *FetchPage(page_id_t page_id) override;
+
+  Page *FetchPage(page_id_t page_id, BufferRing *ring) override;
+
+  /**
+   * Create a ring made of one smaller ring per shard, each holding at least one frame.
+   */
+  std::unique_ptr<BufferRing> NewBufferRing(size_t ring_size = DEFAULT_BUFFER_RING_SIZE) override;
+
+  Page *TryFetchPage(page_id_t page_id) override;
+
+  bool IsPageReady(page_id_t page_id) override;
+
+  /**
+   * Route every page to its shard, the I/O threads are shared by all shards.
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids, BufferRing *ring = nullptr) override;
+
+  bool UnpinPage(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPage(page_id_t page_id) override;
+
+  /**
+   * Allocate a page on disk and bring it into the shard it belongs to.
+   * If that shard has no free frame, the allocation is rolled back and nullptr is returned.
+   */
+  Page *NewPage(page_id_t &page_id) override;
+
+  bool DeletePage(page_id_t page_id) override;
+
+  bool CheckAllUnpinned() override;
+
+  size_t GetPoolSize() override;
+
+  size_t GetMaxPoolSize() override;
+
+  /** Make every shard record its accesses into trace. */
+  void SetAccessTrace(PageAccessTrace *trace) override;
+
+  /**
+   * Split the new size between the shards as the constructor does. Nothing changes unless every shard can take its
+   * share.
+   */
+  bool Resize(size_t pool_size) override;
+
+  /** @return the counters of the background writer summed with the foreground counters of every shard */
+  BufferWriterStats GetWriterStats() override;
+
+  /** @return the statistics of every shard summed */
+  BufferPoolStats GetBufferStats() override;
+
+  /** @return how the frames of the first shard are backed, every shard allocates its own arena */
+  FrameArenaBacking GetFrameBacking() override;
+
+  /** @return the number of shards */
+  inline size_t GetNumInstances() const { return instances_.size(); }
+
+  /** @return the shard responsible for page_id */
+  inline BufferPoolManager *GetInstance(page_id_t page_id) {
+    return instances_[static_cast<uint32_t>(page_id) % instances_.size()];
+  }
+
+ private:
+  /**
+   * Collect dirty pages from every shard, so that pages which are adjacent on disk but live in different shards are
+   * merged into one write. The shard visited first rotates between rounds.
+   */
+  size_t CollectDirtyPages(double clean_ratio, char *staging, size_t max_pages,
+                           vector<DirtyPage> &dirty_pages) override;
+
+  /** Collect the resident pages of every shard, the shards sharing the clock the pages are stamped with. */
+  void CollectResidentPages(vector<pair<int64_t, page_id_t>> &resident_pages) override;
+
+  /** Bring a page into the shard responsible for it. */
+  Page *NewPageWithId(page_id_t page_id) override;
+
+  std::vector<BufferPoolManager *> instances_;
+  size_t next_collect_instance_{0};  // only used by the background writer thread
+};
+
+#endif  // MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
@@ -0,0 +1,49 @@
+#ifndef MINISQL_PREFETCHER_H
+#define MINISQL_PREFETCHER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+
+class BufferPoolManager;
+class BufferRing;
+
+/**
+ * Prefetcher is a small pool of I/O threads which read pages into a buffer pool ahead of the scans which will fetch
+ * them, see BufferPoolManager::PrefetchPages(). Requests are served in the order they were submitted.
+ */
+class Prefetcher {
+ public:
+  explicit Prefetcher(size_t num_threads);
+
+  /**
+   * Drop the requests which have not started yet and wait for the running ones.
+   */
+  ~Prefetcher();
+
+  /**
+   * Queue a read of page_id into bpm, through ring if it is not nullptr.
+   */
+  void Submit(BufferPoolManager *bpm, page_id_t page_id, BufferRing *ring);
+
+ private:
+  struct Request {
+    BufferPoolManager *bpm;
+    page_id_t page_id;
+    BufferRing *ring;
+  };
+
+  void WorkerLoop();
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<Request> requests_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+};
+
+#endif  // MINISQL_PREFETCHER_H
@@ -5,6 +5,11 @@
 
 #include "common/config.h"
 
+/**
+ * Replacement policies a BufferPoolManager can be built with.
+ */
+enum class ReplacerType { kLRU, kClock, kLRUK };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -33,6 +38,20 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Forget a frame whose page has been deleted, so that the next page placed in it starts without history.
+   * Policies that keep no per-frame history can rely on Pin().
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Change the number of frames of the buffer pool when it is resized. Frames beyond num_pages have been removed
+   * before a shrink, and frame ids below num_pages may be used from now on.
+   * @param num_pages the maximum number of pages the replacer will be required to store
+   */
+  virtual void SetCapacity(size_t num_pages) = 0;
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
@@ -13,8 +13,29 @@ static constexpr int META_PAGE_ID = 0;          // physical page id of the disk
 static constexpr int CATALOG_META_PAGE_ID = 0;  // logical page id of the catalog meta data
 static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index roots
 
-static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
+// size of a data page in byte, chosen at build time with the MINISQL_PAGE_SIZE CMake option
+#ifndef MINISQL_PAGE_SIZE
+#define MINISQL_PAGE_SIZE 4096
+#endif
+static constexpr int PAGE_SIZE = MINISQL_PAGE_SIZE;
+static_assert(PAGE_SIZE == 4096 || PAGE_SIZE == 8192 || PAGE_SIZE == 16384 || PAGE_SIZE == 32768,
+              "Pages are 4, 8, 16 or 32 KB.");
+
+static constexpr size_t CACHELINE_SIZE = 64;            // alignment of the frame descriptors of a buffer pool
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;  // huge page size frame arenas are aligned to
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;  // default size of buffer pool
+static constexpr int DEFAULT_BUFFER_POOL_INSTANCES = 8;  // default number of buffer pool shards
+static constexpr int MAX_BUFFER_POOL_SIZE = 4 * DEFAULT_BUFFER_POOL_SIZE;  // frames a database's pool may grow to
+static constexpr size_t LRUK_REPLACER_K = 2;             // lookback window for lru-k replacer
+static constexpr size_t DEFAULT_BUFFER_RING_SIZE = 16;   // frames in the private ring of a bulk read
+static constexpr double DEFAULT_BG_WRITER_CLEAN_RATIO = 0.25;  // fraction of frames the background writer keeps clean
+static constexpr size_t BG_WRITER_MAX_PAGES = 64;              // pages written per background writer round
+static constexpr int BG_WRITER_INTERVAL_MS = 10;               // pause of the background writer when it is idle
+static constexpr size_t DEFAULT_PREFETCH_THREADS = 4;          // I/O threads serving read-ahead requests
+static constexpr size_t DEFAULT_READ_AHEAD_PAGES = 8;          // pages scans keep in flight in front of the cursor
+static constexpr size_t TABLE_HEAP_GROWTH_PAGES = 8;           // pages a full table heap is extended by at once
+static constexpr unsigned DEFAULT_IO_URING_DEPTH = 64;         // asynchronous requests a disk manager keeps in flight
+static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;            // alignment of the buffers of direct I/O (O_DIRECT)
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
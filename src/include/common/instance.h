@@ -5,6 +5,7 @@
 #include <string>
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "catalog/catalog.h"
 #include "common/config.h"
 #include "common/dberr.h"
@@ -14,7 +15,20 @@
 
 class DBStorageEngine {
  public:
-  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+  /**
+   * @param buffer_pool_instances number of buffer pool shards, a single BufferPoolManager is used if it is 1
+   * @param read_only open an existing database read-only, its pages are used in place from a mapping of the db file
+   * and the buffer pool size does not apply
+   * @param direct_io read and write the db file with O_DIRECT, so that the buffer pool holds the only cached copy of
+   * its pages, see DiskManager
+   * @param compress_pages store the pages of the db file compressed, which it keeps doing once it did
+   *
+   * An existing database reloads in the background the pages its buffer pool held when it was last closed, listed
+   * by the destructor in a sidecar file next to the db file.
+   */
+  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           uint32_t buffer_pool_instances = DEFAULT_BUFFER_POOL_INSTANCES, bool read_only = false,
+                           bool direct_io = false, bool compress_pages = false);
 
   ~DBStorageEngine();
 
@@ -0,0 +1,70 @@
+#ifndef MINISQL_MEM_HEAP_H
+#define MINISQL_MEM_HEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/macros.h"
+
+/**
+ * MemHeap is an arena: memory is handed out by bumping a pointer through large blocks, and only given back all at
+ * once, when the heap is reset or destroyed. Objects are placed in it with ALLOC / ALLOC_P and are never destructed,
+ * so they must not own memory outside the heap.
+ *
+ * A statement allocates its rows and fields in the heap of its ExecuteContext (see Row), which turns one malloc and
+ * one free per field into a pointer bump, and releases them when the statement ends.
+ */
+class MemHeap {
+ public:
+  explicit MemHeap(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size_(block_size) {}
+
+  ~MemHeap();
+
+  DISALLOW_COPY_AND_MOVE(MemHeap);
+
+  /**
+   * @return size bytes aligned to ALIGNMENT, valid until the heap is reset or destroyed
+   */
+  inline void *Allocate(size_t size) {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    num_allocations_++;
+    allocated_bytes_ += size;
+    if (size > static_cast<size_t>(end_ - cur_)) {
+      return AllocateBlock(size);
+    }
+    void *ptr = cur_;
+    cur_ += size;
+    return ptr;
+  }
+
+  /**
+   * Give back everything allocated at once. The first block is kept for the allocations that follow.
+   */
+  void Reset();
+
+  /** @return number of allocations since the heap was created or reset */
+  inline size_t GetNumAllocations() const { return num_allocations_; }
+
+  /** @return number of bytes allocated since the heap was created or reset, rounded up to ALIGNMENT */
+  inline size_t GetAllocatedBytes() const { return allocated_bytes_; }
+
+  /** @return number of blocks the heap holds */
+  inline size_t GetNumBlocks() const { return blocks_.size(); }
+
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+  static constexpr size_t ALIGNMENT = alignof(uint64_t);
+
+ private:
+  /** Allocate from a new block, one of its own if size is a large part of a block */
+  void *AllocateBlock(size_t size);
+
+  const size_t block_size_;
+  std::vector<char *> blocks_;
+  char *cur_{nullptr};  // 当前block中下一次分配的位置
+  char *end_{nullptr};  // 当前block的末尾
+  size_t num_allocations_{0};
+  size_t allocated_bytes_{0};
+};
+
+#endif  // MINISQL_MEM_HEAP_H
@@ -8,6 +8,7 @@
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
 #include "common/macros.h"
+#include "common/mem_heap.h"
 #include "concurrency/txn.h"
 
 class ExecuteContext {
@@ -17,9 +18,10 @@ class ExecuteContext {
    * @param transaction The recovery executing the query
    * @param catalog The catalog that the executor uses
    * @param bpm The buffer pool manager that the executor uses
+   * @param use_mem_heap allocate the rows of the query in the MemHeap of the context rather than one by one
    */
-  ExecuteContext(Txn *transaction, CatalogManager *catalog, BufferPoolManager *bpm)
-      : transaction_(transaction), catalog_{catalog}, bpm_{bpm} {}
+  ExecuteContext(Txn *transaction, CatalogManager *catalog, BufferPoolManager *bpm, bool use_mem_heap = true)
+      : transaction_(transaction), catalog_{catalog}, bpm_{bpm}, use_mem_heap_(use_mem_heap) {}
 
   ~ExecuteContext() = default;
 
@@ -34,6 +36,19 @@ class ExecuteContext {
   /** @return the buffer pool manager */
   BufferPoolManager *GetBufferPoolManager() { return bpm_; }
 
+  /**
+   * @return the heap the rows and fields of the query are allocated in, released with the context at the end of the
+   * statement; nullptr if they are allocated one by one
+   */
+  MemHeap *GetMemHeap() { return use_mem_heap_ ? &mem_heap_ : nullptr; }
+
+  /**
+   * @return the heap of the scratch rows of the tuple an insert, update or delete is working on, which the executor
+   * resets before each tuple so that the memory of the statement does not grow with the number of rows; nullptr if
+   * the rows are allocated one by one
+   */
+  MemHeap *GetTupleMemHeap() { return use_mem_heap_ ? &tuple_mem_heap_ : nullptr; }
+
  private:
   /** The recovery context associated with this executor context */
   Txn *transaction_;
@@ -41,6 +56,12 @@ class ExecuteContext {
   CatalogManager *catalog_;
   /** The buffer pool manager associated with this executor context */
   BufferPoolManager *bpm_;
+  /** Whether rows are allocated in mem_heap_ */
+  bool use_mem_heap_;
+  /** The memory of the rows of the query */
+  MemHeap mem_heap_;
+  /** The memory of the rows of the tuple being modified */
+  MemHeap tuple_mem_heap_;
 };
 
 #endif  // MINISQL_EXECUTE_CONTEXT_H
@@ -73,6 +73,16 @@ class ExecuteEngine {
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  /**
+   * Print the buffer pool statistics of the current database, by page kind.
+   */
+  dberr_t ExecuteShowBufferStatus(pSyntaxNode ast, ExecuteContext *context);
+
+  /**
+   * Change a setting of the current database, for now only buffer_pool_size which resizes its buffer pool online.
+   */
+  dberr_t ExecuteSetVariable(pSyntaxNode ast, ExecuteContext *context);
+
  private:
   std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all opened databases */
   std::string current_db_;                                 /** current database */
@@ -36,8 +36,6 @@ class IndexScanExecutor : public AbstractExecutor {
 
   bool SchemaEqual(const Schema *table_schema, const Schema *output_schema);
 
-  void TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row, Row *output_row);
-
  private:
   vector<RowId> IndexScan(AbstractExpressionRef predicate);
 
@@ -47,4 +45,5 @@ class IndexScanExecutor : public AbstractExecutor {
   vector<RowId> result_;
   size_t cursor_ = 0;
   bool is_schema_same_;
+  std::vector<uint32_t> column_ids_;  // 输出的各列在表中的下标
 };
\ No newline at end of file
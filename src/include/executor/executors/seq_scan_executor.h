@@ -39,8 +39,6 @@ class SeqScanExecutor : public AbstractExecutor {
 
   bool SchemaEqual(const Schema *table_schema, const Schema *output_schema);
 
-  void TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row, Row *output_row);
-
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
@@ -48,6 +46,7 @@ class SeqScanExecutor : public AbstractExecutor {
   TableIterator iterator_;
   const Schema *schema_{};
   bool is_schema_same_;
+  std::vector<uint32_t> column_ids_;  // 输出的各列在表中的下标
 };
 
 #endif  // MINISQL_SEQ_SCAN_EXECUTOR_H
@@ -48,8 +48,9 @@ class UpdateExecutor : public AbstractExecutor {
    * Given a row, creates a new, updated row
    * based on the `UpdateInfo` provided in the plan.
    * @param src_row The row to be updated
+   * @param[out] dest_row The updated row
    */
-  Row GenerateUpdatedTuple(const Row &src_row);
+  void GenerateUpdatedTuple(const Row &src_row, Row *dest_row);
 
   /** The update plan node to be executed */
   const UpdatePlanNode *plan_;
@@ -2,9 +2,12 @@
 #define MINISQL_GENERIC_KEY_H
 
 #include <cstring>
+#include <vector>
 
 #include "record/field.h"
+#include "record/field_comparator.h"
 #include "record/row.h"
+#include "record/row_view.h"
 
 class GenericKey {
   friend class KeyManager;
@@ -34,22 +37,17 @@ class KeyManager {
   // compare
   [[nodiscard]] inline int CompareKeys(const GenericKey *lhs, const GenericKey *rhs) const {
     //    ASSERT(malloc_usable_size((void *)&lhs) == malloc_usable_size((void *)&rhs), "key size not match.");
-    uint32_t column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    DeserializeToKey(lhs, lhs_key, key_schema_);
-    DeserializeToKey(rhs, rhs_key, key_schema_);
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue) {
-        return -1;
+    //直接在序列化的键上比较，每列使用构造时按类型选好的比较函数
+    RowView lhs_key(lhs->data, key_schema_);
+    RowView rhs_key(rhs->data, key_schema_);
+    for (uint32_t i = 0; i < column_comparators_.size(); i++) {
+      // null与任何值都不可比，视为相等
+      if (lhs_key.IsNull(i) || rhs_key.IsNull(i)) {
+        continue;
       }
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue) {
-        return 1;
+      int cmp = column_comparators_[i](lhs_key, rhs_key, i);
+      if (cmp != 0) {
+        return cmp < 0 ? -1 : 1;
       }
     }
     // equals
@@ -61,14 +59,20 @@ class KeyManager {
   KeyManager(const KeyManager &other) {
     this->key_schema_ = other.key_schema_;
     this->key_size_ = other.key_size_;
+    this->column_comparators_ = other.column_comparators_;
   }
 
   // constructor
-  KeyManager(Schema *key_schema, size_t key_size) : key_size_(key_size), key_schema_(key_schema) {}
+  KeyManager(Schema *key_schema, size_t key_size) : key_size_(key_size), key_schema_(key_schema) {
+    for (auto column : key_schema_->GetColumns()) {
+      column_comparators_.push_back(GetViewFieldComparator(column->GetType()));
+    }
+  }
 
  private:
   int key_size_;
   Schema *key_schema_;
+  std::vector<ViewFieldComparator> column_comparators_;  // 键的每一列的比较函数
 };
 
 #endif  // MINISQL_GENERIC_KEY_H
@@ -1,6 +1,8 @@
 #ifndef MINISQL_INDEX_ITERATOR_H
 #define MINISQL_INDEX_ITERATOR_H
 
+#include <deque>
+
 #include "page/b_plus_tree_leaf_page.h"
 
 class IndexIterator {
@@ -27,11 +29,18 @@ class IndexIterator {
   bool operator!=(const IndexIterator &itr) const;
 
  private:
+  /**
+   * Keep DEFAULT_READ_AHEAD_PAGES leaves in flight in front of the cursor. The ids of the next leaves are taken from
+   * the parent of the current leaf, so that they are all read at once rather than one leaf after another.
+   */
+  void ReadAhead();
+
   page_id_t current_page_id{INVALID_PAGE_ID};
   LeafPage *page{nullptr};
   int item_index{0};
   BufferPoolManager *buffer_pool_manager{nullptr};
   // add your own private member variables here
+  std::deque<page_id_t> read_ahead;  // 已预读、游标尚未到达的叶子节点，按键值顺序
 };
 
 #endif  // MINISQL_INDEX_ITERATOR_H
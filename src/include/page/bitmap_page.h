@@ -1,11 +1,15 @@
 #ifndef MINISQL_BITMAP_PAGE_H
 #define MINISQL_BITMAP_PAGE_H
 
-#include <bitset>
+#include <cstdint>
 
 #include "common/config.h"
 #include "common/macros.h"
 
+/**
+ * BitmapPage records which pages of an extent are allocated, one bit per page, the most significant bit of a byte
+ * first. Free pages are searched 64 bits at a time.
+ */
 template <size_t PageSize>
 class BitmapPage {
  public:
@@ -20,6 +24,13 @@ class BitmapPage {
    */
   bool AllocatePage(uint32_t &page_offset);
 
+  /**
+   * Allocate num_pages consecutive pages, the first run of free pages long enough.
+   * @param page_offset Index in extent of the first page allocated.
+   * @return false if no run of num_pages free pages exists.
+   */
+  bool AllocatePages(uint32_t num_pages, uint32_t &page_offset);
+
   /**
    * @return true if successfully de-allocate a page.
    */
@@ -40,8 +51,26 @@ class BitmapPage {
    */
   bool IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const;
 
+  /**
+   * @return the word_index-th 64 bits of the bitmap, the bit of its first page being the most significant one
+   */
+  uint64_t LoadWord(size_t word_index) const;
+
+  /**
+   * @return the first free page at or after from, wrapping around to the start of the extent, or
+   * GetMaxSupportedSize() if every page is allocated
+   */
+  uint32_t FindFreePage(uint32_t from) const;
+
+  /**
+   * @return the first allocated page at or after from, GetMaxSupportedSize() if there is none
+   */
+  uint32_t FindAllocatedPage(uint32_t from) const;
+
   /** Note: need to update if modify page structure. */
   static constexpr size_t MAX_CHARS = PageSize - 2 * sizeof(uint32_t);
+  static constexpr size_t NUM_WORDS = MAX_CHARS / 8;
+  static_assert(MAX_CHARS % 8 == 0, "The bitmap is searched by 64-bit words.");
 
  private:
   /** The space occupied by all members of the class should be equal to the PageSize */
@@ -2,10 +2,18 @@
 #define MINISQL_DISK_FILE_META_PAGE_H
 
 #include <cstdint>
+#include <climits>
 
 #include "page/bitmap_page.h"
 
-static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 8) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+// the last word of the meta page holds the flags of the file, the words before it the used pages of the extents
+static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 12) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+// logical page ids, and the physical ones which also count the meta page and a bitmap page per extent, fit page_id_t
+static_assert(static_cast<int64_t>((PAGE_SIZE - 12) / 4) * (BitmapPage<PAGE_SIZE>::GetMaxSupportedSize() + 1) + 1 <=
+                  INT32_MAX,
+              "Too many pages for page_id_t.");
+
+static constexpr uint32_t DISK_FILE_COMPRESSED = 1;  // pages may be stored compressed, see DiskManager
 
 class DiskFileMetaPage {
  public:
@@ -20,10 +28,17 @@ class DiskFileMetaPage {
     return extent_used_page_[extent_id];
   }
 
+  uint32_t GetFlags() { return *FlagsWord(); }
+
+  void SetFlags(uint32_t flags) { *FlagsWord() = flags; }
+
  public:
   uint32_t num_allocated_pages_{0};
   uint32_t num_extents_{0};  // each extent consists with a bit map and BIT_MAP_SIZE pages
   uint32_t extent_used_page_[0];
+
+ private:
+  uint32_t *FlagsWord() { return reinterpret_cast<uint32_t *>(reinterpret_cast<char *>(this) + PAGE_SIZE) - 1; }
 };
 
 #endif  // MINISQL_DISK_FILE_META_PAGE_H
@@ -1,27 +1,45 @@
 #ifndef MINISQL_PAGE_H
 #define MINISQL_PAGE_H
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <shared_mutex>
 
 #include "common/config.h"
 #include "common/rwlatch.h"
 
+/**
+ * What a page holds, as far as the buffer pool can tell from its content, see BufferPoolManager::ClassifyPage().
+ */
+enum class PageKind : uint8_t { kOther = 0, kTable, kIndexInternal, kIndexLeaf, kCatalog };
+
+static constexpr size_t NUM_PAGE_KINDS = 5;
+
 /**
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The page only points to its data. The data of a buffer pool page lives in a frame of the pool or, for a database
+ * opened read-only with DiskIOBackend::kMmap, in place in the mapping of the db file. A page created on its own owns
+ * its data.
+ *
+ * Pages of a buffer pool are frame descriptors kept in a dense array apart from the frames, each aligned to a cache
+ * line, so that scans over the descriptors do not drag page data into the cache and the latches of neighbouring
+ * frames do not share a line. The pin count, kind and recency are atomic because FetchPage() pins a page which is
+ * already pinned without the latch of the pool.
  */
-class Page {
+class alignas(CACHELINE_SIZE) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManager;
 
  public:
   DISALLOW_COPY(Page)
 
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor of a page on its own. Zeros out the page data. */
+  Page() : own_data_(new char[PAGE_SIZE]()) { data_ = own_data_.get(); }
 
   /** Default destructor. */
   ~Page() = default;
@@ -38,6 +56,9 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline bool IsDirty() { return is_dirty_; }
 
+  /** @return what the page held when the buffer pool last looked at it */
+  inline PageKind GetKind() { return kind_; }
+
   /** Acquire the page write latch. */
   inline void WLatch() { rwlatch_.WLock(); }
 
@@ -65,19 +86,29 @@ class Page {
   static constexpr size_t OFFSET_LSN = 4;
 
  private:
+  /** Constructor of a buffer pool page, whose data is a frame or nullptr until the page is mapped. */
+  explicit Page(char *data) : data_(data) {}
+
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
+  // The book-keeping read by scans over the frames comes first, in the first cache line of the descriptor.
   /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  char *data_{nullptr};
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
   /** The pin count of this page. */
-  int pin_count_ = 0;
+  std::atomic<int> pin_count_{0};
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
+  /** What the page holds, for the statistics of the buffer pool. */
+  std::atomic<PageKind> kind_{PageKind::kOther};
+  /** When the page was last pinned, in steady clock ticks, to order the resident pages by recency. */
+  std::atomic<int64_t> last_used_{0};
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** The data of a page created on its own. */
+  std::unique_ptr<char[]> own_data_;
 };
 
 #endif  // MINISQL_PAGE_H
@@ -25,6 +25,7 @@
 #include "concurrency/txn.h"
 #include "page/page.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "recovery/log_manager.h"
 
 class TablePage : public Page {
@@ -58,6 +59,12 @@ class TablePage : public Page {
 
   bool GetTuple(Row *row, Schema *schema, Txn *txn, LockManager *lock_manager);
 
+  /**
+   * Point view at the tuple at rid in this page, without copying it out.
+   * @return false if the tuple does not exist
+   */
+  bool GetTupleView(const RowId &rid, const Schema *schema, RowView *view);
+
   bool GetFirstTupleRid(RowId *first_rid);
 
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
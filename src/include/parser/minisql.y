@@ -1,5 +1,6 @@
 %{
   #include <stdio.h>
+  #include <string.h>
   #include "parser/parser.h"
 
   extern char *yytext;
@@ -7,6 +8,8 @@
   int yyerror(char* error);
 %}
 
+%define api.header.include {"parser/minisql_yacc.h"}
+
 %union {
 	pSyntaxNode syntax_node;
 }
@@ -27,7 +30,7 @@
 %type <syntax_node> sql_select select_columns column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
 %type <syntax_node> sql_insert sql_delete sql_update update_values update_value
-%type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_quit sql_exec_file sql_show_buffer_status sql_set_variable
 
 %%
 
@@ -58,6 +61,8 @@ sql:
   | sql_trx_rollback { $$ = $1; }
   | sql_quit { $$ = $1; }
   | sql_exec_file { $$ = $1; }
+  | sql_show_buffer_status { $$ = $1; }
+  | sql_set_variable { $$ = $1; }
   ;
 
 sql_create_database:
@@ -393,6 +398,25 @@ sql_exec_file:
   }
   ;
 
+sql_show_buffer_status:
+  SHOW IDENTIFIER IDENTIFIER {
+    /* buffer and status are not keywords, they stay usable as names */
+    if (strcmp($2->val_, "buffer") != 0 || strcmp($3->val_, "status") != 0) {
+      yyerror("syntax error");
+      YYERROR;
+    }
+    $$ = CreateSyntaxNode(kNodeShowBufferStatus, NULL);
+  }
+  ;
+
+sql_set_variable:
+  SET IDENTIFIER EQ NUMBER {
+    $$ = CreateSyntaxNode(kNodeSetVariable, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
 %%
 int yyerror(char* error) {
 	MinisqlParserSetError(error);
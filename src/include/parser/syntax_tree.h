@@ -43,7 +43,9 @@ typedef enum {
   kNodeIndexType,            /** type of index */
   kNodeTrxBegin,             /** begin recovery command */
   kNodeTrxCommit,            /** commit recovery command */
-  kNodeTrxRollback           /** rollback recovery command */
+  kNodeTrxRollback,          /** rollback recovery command */
+  kNodeShowBufferStatus,     /** show buffer status command */
+  kNodeSetVariable           /** set variable command */
 } SyntaxNodeType;
 
 /**
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "record/row.h"
+#include "record/row_view.h"
 #include "record/schema.h"
 
 class AbstractExpression;
@@ -36,6 +37,13 @@ class AbstractExpression {
   /** @return The field obtained by evaluating the row */
   virtual Field Evaluate(const Row *row) const = 0;
 
+  /**
+   * Evaluate the row in place, e.g. a predicate on a tuple still in its page. The field returned may point into the
+   * row bytes, so it is only valid as long as the view.
+   * @return The field obtained by evaluating the row
+   */
+  virtual Field Evaluate(const RowView &row) const = 0;
+
   /**
    * Returns the field obtained by evaluating a JOIN.
    * @param left_row The left row
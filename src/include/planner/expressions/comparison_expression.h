@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "abstract_expression.h"
+#include "record/field_comparator.h"
 #include "record/schema.h"
 
 /**
@@ -18,7 +19,26 @@ class ComparisonExpression : public AbstractExpression {
   /** Creates a new comparison expression representing (left comp_type right). */
   ComparisonExpression(AbstractExpressionRef left, AbstractExpressionRef right, string comp_type)
       : AbstractExpression({std::move(left), std::move(right)}, TypeId::kTypeInt, ExpressionType::ComparisonExpression),
-        comp_type_{std::move(comp_type)} {}
+        comp_type_{std::move(comp_type)} {
+    // 操作符和比较函数在建立表达式时选好，求值时不再比较字符串、不再经过Type的虚函数
+    if (comp_type_ == "is") {
+      kind_ = OpKind::kIsNull;
+    } else if (comp_type_ == "not") {
+      kind_ = OpKind::kIsNotNull;
+    } else {
+      static const std::pair<const char *, CompareOp> ops[] = {
+          {"=", CompareOp::kEquals},          {"<>", CompareOp::kNotEquals},  {"<", CompareOp::kLessThan},
+          {"<=", CompareOp::kLessThanEquals}, {">", CompareOp::kGreaterThan}, {">=", CompareOp::kGreaterThanEquals}};
+      for (auto &op : ops) {
+        if (comp_type_ == op.first) {
+          kind_ = OpKind::kCompare;
+          op_ = op.second;
+        }
+      }
+      type_ = GetChildAt(0)->GetReturnType();
+      comparator_ = GetFieldComparator(type_, op_);
+    }
+  }
 
   /** e.g. evaluate the result of id = 1 */
   Field Evaluate(const Row *row) const override {
@@ -27,6 +47,12 @@ class ComparisonExpression : public AbstractExpression {
     return Field(kTypeInt, PerformComparison(lhs, rhs));
   }
 
+  Field Evaluate(const RowView &row) const override {
+    Field lhs = GetChildAt(0)->Evaluate(row);
+    Field rhs = GetChildAt(1)->Evaluate(row);
+    return Field(kTypeInt, PerformComparison(lhs, rhs));
+  }
+
   Field EvaluateJoin(const Row *left_row, const Row *right_row) const override {
     Field lhs = GetChildAt(0)->EvaluateJoin(left_row, right_row);
     Field rhs = GetChildAt(1)->EvaluateJoin(left_row, right_row);
@@ -37,27 +63,31 @@ class ComparisonExpression : public AbstractExpression {
 
  private:
   CmpBool PerformComparison(const Field &lhs, const Field &rhs) const {
-    if (comp_type_ == "=")
-      return lhs.CompareEquals(rhs);
-    else if (comp_type_ == "<>")
-      return lhs.CompareNotEquals(rhs);
-    else if (comp_type_ == "<")
-      return lhs.CompareLessThan(rhs);
-    else if (comp_type_ == "<=")
-      return lhs.CompareLessThanEquals(rhs);
-    else if (comp_type_ == ">")
-      return lhs.CompareGreaterThan(rhs);
-    else if (comp_type_ == ">=")
-      return lhs.CompareGreaterThanEquals(rhs);
-    else if (comp_type_ == "is")
-      return GetCmpBool(lhs.IsNull());
-    else if (comp_type_ == "not")
-      return GetCmpBool(!lhs.IsNull());
-    else
-      throw std::logic_error("Unsupported comparison type");
+    switch (kind_) {
+      case OpKind::kCompare: {
+        // 子表达式的类型与声明的不同时按实际类型重新选择
+        FieldComparator comparator = lhs.GetTypeId() == type_ ? comparator_ : GetFieldComparator(lhs.GetTypeId(), op_);
+        if (comparator == nullptr) {
+          throw std::logic_error("Unsupported comparison type");
+        }
+        return comparator(lhs, rhs);
+      }
+      case OpKind::kIsNull:
+        return GetCmpBool(lhs.IsNull());
+      case OpKind::kIsNotNull:
+        return GetCmpBool(!lhs.IsNull());
+      default:
+        throw std::logic_error("Unsupported comparison type");
+    }
   }
 
+  enum class OpKind { kUnsupported, kCompare, kIsNull, kIsNotNull };
+
   std::string comp_type_;
+  OpKind kind_{OpKind::kUnsupported};
+  CompareOp op_{CompareOp::kEquals};
+  TypeId type_{TypeId::kTypeInvalid};  // 左侧子表达式的类型
+  FieldComparator comparator_{nullptr};
 };
 
 #endif  // MINISQL_COMPARISON_EXPRESSION_H
@@ -18,11 +18,16 @@ class Field {
 
   friend class TypeFloat;
 
+  friend class Row;
+
+  template <TypeId type>
+  friend struct TypeComparator;
+
  public:
   explicit Field(const TypeId type) : type_id_(type), len_(FIELD_NULL_LEN), is_null_(true) {}
 
   ~Field() {
-    if (type_id_ == TypeId::kTypeChar && manage_data_) {
+    if (type_id_ == TypeId::kTypeChar && manage_data_ && !IsInline()) {
       delete[] value_.chars_;
     }
   }
@@ -50,14 +55,17 @@ class Field {
       value_.chars_ = nullptr;
       manage_data_ = false;
     } else {
-      if (manage_data) {
+      len_ = len;
+      if (!manage_data) {
+        value_.chars_ = data;
+      } else if (IsInline()) {
+        //短字符串直接存在value_中，不用分配
+        memcpy(value_.inline_, data, len);
+      } else {
         ASSERT(len < VARCHAR_MAX_LEN, "Field length exceeds max varchar length");
         value_.chars_ = new char[len];
         memcpy(value_.chars_, data, len);
-      } else {
-        value_.chars_ = data;
       }
-      len_ = len;
     }
   }
 
@@ -67,7 +75,7 @@ class Field {
     len_ = other.len_;
     is_null_ = other.is_null_;
     manage_data_ = other.manage_data_;
-    if (type_id_ == TypeId::kTypeChar && !is_null_ && manage_data_) {
+    if (type_id_ == TypeId::kTypeChar && !is_null_ && manage_data_ && !IsInline()) {
       value_.chars_ = new char[len_];
       memcpy(value_.chars_, other.value_.chars_, len_);
     } else {
@@ -138,17 +146,27 @@ class Field {
       return std::to_string(value_.float_);
     else {
       char temp[len_ + 1];
-      memcpy(temp, value_.chars_, len_);
+      memcpy(temp, GetChars(), len_);
       temp[len_] = '\0';
       return {temp};
     }
   }
 
+  /** CHAR data of at most this many bytes owned by the field is stored in the field itself */
+  static constexpr uint32_t INLINE_CHARS = sizeof(char *);
+
  protected:
+  /** @return whether the characters of this CHAR field are stored inline in value_ */
+  inline bool IsInline() const { return manage_data_ && len_ <= INLINE_CHARS; }
+
+  /** @return the characters of a CHAR field, wherever they are stored */
+  inline const char *GetChars() const { return IsInline() ? value_.inline_ : value_.chars_; }
+
   union Val {
     int32_t integer_;
     float float_;
     char *chars_;
+    char inline_[INLINE_CHARS];  // manage_data_且len_ <= INLINE_CHARS时的CHAR数据
   } value_;
   TypeId type_id_;
   uint32_t len_;
@@ -0,0 +1,110 @@
+#ifndef MINISQL_FIELD_COMPARATOR_H
+#define MINISQL_FIELD_COMPARATOR_H
+
+#include <algorithm>
+#include <cstring>
+
+#include "record/field.h"
+#include "record/row_view.h"
+
+/** The comparison operators, in the order of the Field::CompareXXX methods */
+enum class CompareOp { kEquals = 0, kNotEquals, kLessThan, kLessThanEquals, kGreaterThan, kGreaterThanEquals };
+
+/**
+ * TypeComparator<type> compares two non-null values of type, returning <0, 0 or >0 like memcmp. Unlike the
+ * Field::CompareXXX methods it is resolved at compile time, without the Type singleton and its virtual methods, so
+ * it inlines into the kernels below, which are instantiated for every type (and operator).
+ */
+template <TypeId type>
+struct TypeComparator;
+
+template <>
+struct TypeComparator<TypeId::kTypeInt> {
+  static inline int Compare(const Field &lhs, const Field &rhs) {
+    return (lhs.value_.integer_ > rhs.value_.integer_) - (lhs.value_.integer_ < rhs.value_.integer_);
+  }
+
+  static inline int Compare(const RowView &lhs, const RowView &rhs, uint32_t idx) {
+    int32_t l = lhs.GetInt(idx), r = rhs.GetInt(idx);
+    return (l > r) - (l < r);
+  }
+};
+
+template <>
+struct TypeComparator<TypeId::kTypeFloat> {
+  static inline int Compare(const Field &lhs, const Field &rhs) {
+    return (lhs.value_.float_ > rhs.value_.float_) - (lhs.value_.float_ < rhs.value_.float_);
+  }
+
+  static inline int Compare(const RowView &lhs, const RowView &rhs, uint32_t idx) {
+    float l = lhs.GetFloat(idx), r = rhs.GetFloat(idx);
+    return (l > r) - (l < r);
+  }
+};
+
+template <>
+struct TypeComparator<TypeId::kTypeChar> {
+  static inline int Compare(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len) {
+    int ret = memcmp(lhs, rhs, std::min(lhs_len, rhs_len));
+    return ret != 0 ? ret : (lhs_len > rhs_len) - (lhs_len < rhs_len);
+  }
+
+  static inline int Compare(const Field &lhs, const Field &rhs) {
+    return Compare(lhs.GetChars(), lhs.len_, rhs.GetChars(), rhs.len_);
+  }
+
+  static inline int Compare(const RowView &lhs, const RowView &rhs, uint32_t idx) {
+    uint32_t lhs_len, rhs_len;
+    const char *l = lhs.GetChars(idx, &lhs_len);
+    const char *r = rhs.GetChars(idx, &rhs_len);
+    return Compare(l, lhs_len, r, rhs_len);
+  }
+};
+
+/** @return whether the result cmp of a three way comparison satisfies op */
+template <CompareOp op>
+inline bool ApplyCompareOp(int cmp) {
+  if constexpr (op == CompareOp::kEquals) {
+    return cmp == 0;
+  } else if constexpr (op == CompareOp::kNotEquals) {
+    return cmp != 0;
+  } else if constexpr (op == CompareOp::kLessThan) {
+    return cmp < 0;
+  } else if constexpr (op == CompareOp::kLessThanEquals) {
+    return cmp <= 0;
+  } else if constexpr (op == CompareOp::kGreaterThan) {
+    return cmp > 0;
+  } else {
+    return cmp >= 0;
+  }
+}
+
+/** Same as lhs.CompareXXX(rhs) for the op, for fields of type */
+template <TypeId type, CompareOp op>
+inline CmpBool CompareFields(const Field &lhs, const Field &rhs) {
+  ASSERT(lhs.GetTypeId() == type && rhs.GetTypeId() == type, "Not comparable.");
+  if (lhs.IsNull() || rhs.IsNull()) {
+    return CmpBool::kNull;
+  }
+  return GetCmpBool(ApplyCompareOp<op>(TypeComparator<type>::Compare(lhs, rhs)));
+}
+
+/** Three way comparison of the non-null field at idx of two views, of type */
+template <TypeId type>
+inline int CompareViewFields(const RowView &lhs, const RowView &rhs, uint32_t idx) {
+  return TypeComparator<type>::Compare(lhs, rhs, idx);
+}
+
+using FieldComparator = CmpBool (*)(const Field &, const Field &);
+using ViewFieldComparator = int (*)(const RowView &, const RowView &, uint32_t);
+
+/**
+ * Select the kernel once, e.g. when an expression or index is built, and call it for every row or key.
+ * @return CompareFields<type, op>, or nullptr if type has no comparison
+ */
+FieldComparator GetFieldComparator(TypeId type, CompareOp op);
+
+/** @return CompareViewFields<type>, or nullptr if type has no comparison */
+ViewFieldComparator GetViewFieldComparator(TypeId type);
+
+#endif  // MINISQL_FIELD_COMPARATOR_H
@@ -2,9 +2,11 @@
 #define MINISQL_ROW_H
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "common/macros.h"
+#include "common/mem_heap.h"
 #include "common/rowid.h"
 #include "record/field.h"
 #include "record/schema.h"
@@ -19,25 +21,36 @@
  * | Field Nums | Null bitmap |
  * -------------------------------------------
  *
+ *  A row whose schema has a fixed layout (Schema::CompileFixedLayout) is stored with every field at the offset the
+ *  layout gives it, null fields included, and FIXED_FORMAT_FLAG set in Field Nums. A CHAR field is its length followed
+ *  by as many bytes as the column declares. Rows that do not fit the layout, e.g. with a CHAR longer than its column,
+ *  and rows written before there were layouts keep the variable format, where each field follows the one before.
  *
+ *  A row may be given a MemHeap, usually the one of the statement (ExecuteContext::GetMemHeap). Its fields and their
+ *  CHAR data are then allocated in the heap, and freed with it rather than by the row.
  */
 class Row {
+  friend class RowView;
+
  public:
   /**
    * Row used for insert
    * Field integrity should check by upper level
    */
-  Row(std::vector<Field> &fields) {
+  Row(std::vector<Field> &fields, MemHeap *heap = nullptr) : heap_(heap) {
     // deep copy
+    fields_.reserve(fields.size());
     for (auto &field : fields) {
-      fields_.push_back(new Field(field));
+      fields_.push_back(NewField(field));
     }
   }
 
   void destroy() {
     if (!fields_.empty()) {
-      for (auto field : fields_) {
-        delete field;
+      if (heap_ == nullptr) {
+        for (auto field : fields_) {
+          delete field;
+        }
       }
       fields_.clear();
     }
@@ -53,27 +66,39 @@ class Row {
   /**
    * Row used for deserialize and update
    */
-  Row(RowId rid) : rid_(rid) {}
+  Row(RowId rid, MemHeap *heap = nullptr) : rid_(rid), heap_(heap) {}
 
   /**
-   * Row copy function, deep copy
+   * Row used for deserialize, with its fields in heap
    */
-  Row(const Row &other) {
-    destroy();
-    rid_ = other.rid_;
+  explicit Row(MemHeap *heap) : heap_(heap) {}
+
+  /**
+   * Row copy function, deep copy into the heap of other
+   */
+  Row(const Row &other) : rid_(other.rid_), heap_(other.heap_) {
+    fields_.reserve(other.fields_.size());
     for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
+      fields_.push_back(NewField(*field));
     }
   }
 
   /**
-   * Assign operator, deep copy
+   * Move constructor, the fields stay where they are
+   */
+  Row(Row &&other) noexcept : rid_(other.rid_), fields_(std::move(other.fields_)), heap_(other.heap_) {
+    other.fields_.clear();
+  }
+
+  /**
+   * Assign operator, deep copy into the heap of this row
    */
   Row &operator=(const Row &other) {
     destroy();
     rid_ = other.rid_;
+    fields_.reserve(other.fields_.size());
     for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
+      fields_.push_back(NewField(*field));
     }
     return *this;
   }
@@ -107,9 +132,36 @@ class Row {
 
   inline size_t GetFieldCount() const { return fields_.size(); }
 
+  /** Append a copy of field, in the heap of the row if it has one */
+  inline void AppendField(const Field &field) { fields_.push_back(NewField(field)); }
+
+  inline MemHeap *GetMemHeap() const { return heap_; }
+
+  /** Set in the field count of a row in the fixed format */
+  static constexpr uint32_t FIXED_FORMAT_FLAG = 1U << 31;
+
  private:
+  template <typename... Args>
+  inline Field *MakeField(Args &&...args) const {
+    return heap_ == nullptr ? new Field(std::forward<Args>(args)...) : ALLOC_P(heap_, Field)(std::forward<Args>(args)...);
+  }
+
+  /** @return a copy of field owned by the row, with its CHAR data copied into the heap of the row if it has one */
+  Field *NewField(const Field &field) const;
+
+  /** @return a field owned by the row, read from its serialized bytes */
+  Field *ReadField(TypeId type, const char *buf, bool is_null) const;
+
+  /** @return whether the row is written in the fixed layout of schema */
+  bool FitsFixedLayout(const Schema *schema) const;
+
+  uint32_t SerializeFixedTo(char *buf, const Schema *schema) const;
+
+  uint32_t DeserializeFixedFrom(const char *buf, const Schema *schema, uint32_t field_count);
+
   RowId rid_{};
   std::vector<Field *> fields_; /** Make sure that all field ptr are destructed*/
+  MemHeap *heap_{nullptr};      // fields_所在的heap，为空时逐个new和delete
 };
 
 #endif  // MINISQL_ROW_H
@@ -0,0 +1,74 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <vector>
+
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * RowView reads the fields of a serialized row (see Row for the format) in place, without allocating.
+ *
+ * The view points into the bytes it was reset on, usually a tuple of a pinned and latched TablePage, and is only
+ * valid as long as they are. Fields are decoded on access. In the fixed format the offset of a field comes from the
+ * layout of the schema; in the variable format it is found by walking the fields before it, from the last field
+ * looked up when accessing the row in column order. Rows which are kept are copied out with Materialize.
+ */
+class RowView {
+ public:
+  RowView() = default;
+
+  RowView(const char *data, const Schema *schema, RowId rid = RowId()) { Reset(data, schema, rid); }
+
+  /** Point the view at another serialized row */
+  void Reset(const char *data, const Schema *schema, RowId rid = RowId());
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline uint32_t GetFieldCount() const { return field_count_; }
+
+  inline bool IsNull(uint32_t idx) const {
+    ASSERT(idx < field_count_, "Failed to access field");
+    return (null_bitmap_[idx / 8] & (1 << (idx % 8))) != 0;
+  }
+
+  inline int32_t GetInt(uint32_t idx) const { return MACH_READ_INT32(FieldData(idx)); }
+
+  inline float GetFloat(uint32_t idx) const { return MACH_READ_FROM(float, FieldData(idx)); }
+
+  /** @return the characters of a CHAR field, in the row bytes */
+  const char *GetChars(uint32_t idx, uint32_t *len) const;
+
+  /**
+   * @return the field at idx, a CHAR field pointing at the row bytes rather than owning a copy of them, so it must not
+   * outlive the view either
+   */
+  Field GetField(uint32_t idx) const;
+
+  /** Copy all the fields into row, which owns them, or into its heap */
+  void Materialize(Row *row) const;
+
+  /** Copy the fields at column_ids, in that order, into row, which owns them */
+  void Materialize(Row *row, const std::vector<uint32_t> &column_ids) const;
+
+ private:
+  /** @return the serialized bytes of the field at idx, which must not be null */
+  const char *FieldData(uint32_t idx) const;
+
+  /** @return a new field holding a copy of the field at idx, in the heap of row if it has one */
+  Field *CopyField(const Row *row, uint32_t idx) const;
+
+  const char *data_{nullptr};
+  const Schema *schema_{nullptr};
+  RowId rid_{};
+  uint32_t field_count_{0};
+  const char *null_bitmap_{nullptr};
+  bool fixed_{false};  // 行是否为定长格式，是则直接按偏移访问
+  // 最近一次定位到的field及其偏移，按列顺序访问时从这里继续向后找
+  mutable uint32_t cursor_idx_{0};
+  mutable uint32_t cursor_offset_{0};
+};
+
+#endif  // MINISQL_ROW_VIEW_H
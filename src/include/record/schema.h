@@ -39,6 +39,22 @@ class Schema {
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /**
+   * Lay the rows of this schema out at fixed offsets (see Row), if all its columns have a fixed width. A CHAR column
+   * takes the room of its declared length.
+   * @param max_row_size the largest a row may be, e.g. what fits in a table page
+   * @return whether the schema has a fixed layout
+   */
+  bool CompileFixedLayout(uint32_t max_row_size);
+
+  inline bool HasFixedLayout() const { return fixed_row_size_ != 0; }
+
+  /** @return the size of a row in the fixed layout */
+  inline uint32_t GetFixedRowSize() const { return fixed_row_size_; }
+
+  /** @return the offset of a field from the start of a row in the fixed layout */
+  inline uint32_t GetFixedOffset(const uint32_t column_index) const { return fixed_offsets_[column_index]; }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -84,6 +100,8 @@ class Schema {
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;
   bool is_manage_ = false; /** if false, don't need to delete pointer to column */
+  std::vector<uint32_t> fixed_offsets_;  // 定长格式中每个field的偏移
+  uint32_t fixed_row_size_{0};           // 定长格式的行大小，0表示没有定长格式
 };
 
 using IndexSchema = Schema;
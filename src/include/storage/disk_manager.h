@@ -2,15 +2,58 @@
 #define DISK_MGR_H
 
 #include <atomic>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/io_uring.h"
+
+static_assert(PAGE_SIZE % DIRECT_IO_ALIGNMENT == 0, "Pages must be read and written whole with direct I/O.");
+
+/**
+ * How a DiskManager reaches the db file.
+ *
+ * kStream seeks a std::fstream and reads or writes it, so every page access is serialized on the file latch.
+ * kPread uses positional pread/pwrite on a file descriptor, so accesses to different pages run in parallel; only
+ * page allocation and the meta page stay under the latch.
+ * kIoUring is kPread plus an io_uring serving the asynchronous interface. It falls back to kPread when the kernel
+ * does not support io_uring.
+ * kMmap opens an existing db file read-only and maps it: pages are copied out of the mapping, or used in place through
+ * MapPage(). Allocation and writes fail.
+ *
+ * kPread and kIoUring may also open the file with O_DIRECT, so that pages bypass the kernel page cache and the buffer
+ * pool holds the only copy of them. Direct I/O needs buffers aligned to DIRECT_IO_ALIGNMENT: the frames of a buffer
+ * pool are, other buffers go through an aligned bounce buffer.
+ */
+enum class DiskIOBackend { kStream, kPread, kIoUring, kMmap };
+
+/**
+ * Counters of the page compression of a DiskManager, see DiskManager::GetCompressionStats().
+ */
+struct DiskCompressionStats {
+  uint64_t pages_compressed{0};    // page writes stored in a compressed slot
+  uint64_t pages_stored_raw{0};    // page writes which did not shrink by a sector and were stored as they are
+  uint64_t bytes_in{0};            // bytes of the pages written
+  uint64_t bytes_out{0};           // bytes of the slots they were stored in
+  uint64_t compress_ns{0};         // time spent compressing
+  uint64_t pages_decompressed{0};  // page reads of a compressed slot
+  uint64_t bytes_read{0};          // bytes read from the file by page reads
+  uint64_t device_bytes_read{0};   // bytes the device transferred for them, whole pages of the page cache unless direct
+  uint64_t decompress_ns{0};       // time spent decompressing
+
+  /** @return how many times smaller the written pages got, 1 if none was written */
+  double Ratio() const { return bytes_out == 0 ? 1 : static_cast<double>(bytes_in) / bytes_out; }
+};
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
@@ -19,10 +62,36 @@
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * Like the meta page, the bitmap pages are kept in memory once read and only written back, if they changed, by
+ * Close(). Allocation finds the first extent with a free page in a two-level summary of the extents instead of
+ * scanning the meta page, so that it costs no I/O once the bitmap of that extent is cached.
+ *
+ * The file grows an extent at a time: when a page is first allocated in an extent, the backends with a file
+ * descriptor reserve room for the whole extent with fallocate, so that writing new pages neither extends the file
+ * nor allocates blocks, and the extent is laid out contiguously by the file system when it can.
+ *
+ * With compression, which a file keeps once it was opened with it, a page is compressed by PageCodec when it is
+ * written and stored at the start of its place on disk, in a slot of as many SECTOR_SIZE sectors as it needs behind a
+ * header. Pages which would not shrink by a sector are stored as they are. A page map alongside MapPageId() remembers
+ * the slot size of every page so that reads only fetch those sectors; it is only a hint, a read checks the header and
+ * fetches the rest of the page if the slot turns out to be larger. The map is saved next to the db file on Close().
+ * Slots keep the fixed place of their page, so compression does not make the file smaller, only the transfers. The
+ * positional I/O backends read and write the slot alone, with O_DIRECT rounded to the direct I/O block of the file
+ * (usually a sector), so that the device only transfers the slot. Through the page cache the kernel still reads whole
+ * pages, which device_bytes_read accounts for. The stream backend transfers whole pages and only saves the time to
+ * compress them. Pages of a compressed file used in place by MapPage() are decompressed once into memory of the disk
+ * manager.
  */
 class DiskManager {
  public:
-  explicit DiskManager(const std::string &db_file);
+  /**
+   * @param direct_io open the db file with O_DIRECT, only for kPread and kIoUring. Falls back to buffered I/O when
+   * the file system does not support it.
+   * @param compress store the pages of the db file compressed from now on
+   */
+  explicit DiskManager(const std::string &db_file, DiskIOBackend backend = DiskIOBackend::kPread,
+                       bool direct_io = false, bool compress = false);
 
   ~DiskManager() {
     if (!closed) {
@@ -37,17 +106,66 @@ class DiskManager {
   void ReadPage(page_id_t logical_page_id, char *page_data);
 
   /**
-   * Write data to specific page
+   * Write data to specific page, nothing is written to a read-only database
    * Note: page_id = 0 is reserved for free page bit map
    */
   void WritePage(page_id_t logical_page_id, const char *page_data);
 
+  /**
+   * Write a batch of pages in physical page order, merging pages which are adjacent on disk into a single write.
+   * @param pages logical page id and data of every page, each page at most once
+   * @return the number of writes issued, 0 for a read-only database
+   */
+  size_t WritePages(const std::vector<std::pair<page_id_t, const char *>> &pages);
+
+  /**
+   * Queue a read of a page into page_data, issued by the next SubmitAsync(). page_data must stay valid until the
+   * request is reaped. Without io_uring the page is read at once and tag is ready to be reaped.
+   *
+   * The asynchronous interface is driven by one thread at a time: ReapAsync() returns whichever requests completed,
+   * whoever queued them. When all the slots are taken, queueing waits for a request to complete.
+   * @param tag returned by ReapAsync() once the read is done
+   */
+  void ReadPageAsync(page_id_t logical_page_id, char *page_data, uint64_t tag);
+
+  /**
+   * Queue a write of page_data to a page, issued by the next SubmitAsync(), see ReadPageAsync().
+   */
+  void WritePageAsync(page_id_t logical_page_id, const char *page_data, uint64_t tag);
+
+  /**
+   * Hand every queued request to the kernel with a single system call.
+   * @return the number of requests submitted
+   */
+  size_t SubmitAsync();
+
+  /**
+   * Collect completed requests, submitting the queued ones first.
+   * @param[out] tags the tags of the completed requests are appended to it
+   * @param min_complete wait until at least this many requests have completed, or none is left
+   * @return the number of tags appended
+   */
+  size_t ReapAsync(std::vector<uint64_t> &tags, size_t min_complete = 1);
+
+  /** @return the number of asynchronous requests queued, in flight or completed but not reaped yet */
+  size_t GetNumPendingAsync();
+
+  /** @return whether asynchronous requests really overlap, i.e. io_uring is in use */
+  inline bool IsAsyncIOSupported() const { return io_uring_ != nullptr; }
+
   /**
    * Get next free page from disk
    * @return logical page id of allocated page
    */
   page_id_t AllocatePage();
 
+  /**
+   * Allocate num_pages pages with consecutive ids inside one extent, which makes them consecutive on disk as well.
+   * The first extent with a long enough run of free pages is used.
+   * @return logical page id of the first page, INVALID_PAGE_ID if no extent has such a run
+   */
+  page_id_t AllocatePages(size_t num_pages);
+
   /**
    * Free this page and reset bit map
    */
@@ -69,13 +187,56 @@ class DiskManager {
    */
   char *GetMetaData() { return meta_data_; }
 
+  /**
+   * Address of a page in the mapping of the db file, valid until the disk manager is closed.
+   * @return nullptr unless the file is mapped (kMmap) and holds the page
+   */
+  const char *MapPage(page_id_t logical_page_id);
+
+  /** @return whether the db file was opened read-only */
+  inline bool IsReadOnly() const { return backend_ == DiskIOBackend::kMmap; }
+
+  /** @return the way the db file is accessed */
+  inline DiskIOBackend GetBackend() const { return backend_; }
+
+  /** @return whether the db file is accessed with direct I/O, bypassing the page cache */
+  inline bool IsDirectIO() const { return direct_io_; }
+
+  /** @return whether pages are stored compressed */
+  inline bool IsCompressed() const { return compressed_; }
+
+  /** @return the counters of page compression */
+  DiskCompressionStats GetCompressionStats() const;
+
+  /** @return the number of page reads and writes of direct I/O which went through the bounce buffer */
+  inline uint64_t GetNumBouncedIO() const { return num_bounced_io_; }
+
+  /** @return whether a buffer can be used for direct I/O as is */
+  static inline bool IsAligned(const void *data) {
+    return reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT == 0;
+  }
+
+  /** @return the bytes of disk the file system allocated to the db file, including preallocated room */
+  size_t GetFileAllocatedSize();
+
+  /** @return the bytes of the db file holding the meta page, the bitmap pages and the allocated pages */
+  size_t GetFileUsedSize();
+
+  /** @return the number of ReadPage calls so far */
+  inline uint64_t GetNumReads() const { return num_reads_; }
+
+  /** @return the number of WritePage calls so far */
+  inline uint64_t GetNumWrites() const { return num_writes_; }
+
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
+  static constexpr size_t SECTOR_SIZE = 512;  // unit of the slots of compressed pages
+
  private:
   /**
    * Helper function to get disk file size
    */
-  int GetFileSize(const std::string &file_name);
+  int64_t GetFileSize(const std::string &file_name);
 
   /**
    * Read physical page from disk
@@ -83,23 +244,230 @@ class DiskManager {
   void ReadPhysicalPage(page_id_t physical_page_id, char *page_data);
 
   /**
-   * Write data to physical page in disk
+   * Read a physical page through a file descriptor into an aligned buffer if direct I/O is used
+   */
+  void PreadPhysicalPage(page_id_t physical_page_id, char *page_data);
+
+  /**
+   * Read size bytes at offset of the db file through its descriptor, the bytes past the end of the file read as 0
+   */
+  void PreadBytes(size_t offset, char *data, size_t size);
+
+  /**
+   * Write size bytes at offset of the db file through its descriptor
+   */
+  void PwriteBytes(size_t offset, const char *data, size_t size);
+
+  /**
+   * Write data to physical page in disk, or to num_pages consecutive physical pages
+   */
+  void WritePhysicalPage(page_id_t physical_page_id, const char *page_data, size_t num_pages = 1);
+
+  /**
+   * Write num_pages consecutive physical pages through a file descriptor from an aligned buffer if direct I/O is used
+   */
+  void PwritePhysicalPages(page_id_t physical_page_id, const char *page_data, size_t num_pages);
+
+  /**
+   * Write num_pages pages which are consecutive on disk but scattered in memory, starting at a physical page
+   */
+  void WritePhysicalPages(page_id_t physical_page_id, const std::vector<const char *> &pages);
+
+  /**
+   * Read a logical page stored compressed or not, fetching the sectors the page map tells
    */
-  void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
+  void ReadCompressedPage(page_id_t logical_page_id, char *page_data);
+
+  /**
+   * Finish a read of a compressed page whose first read_size bytes are in slot: fetch the rest of the slot, or of the
+   * page if it is not compressed, and decompress it into page_data
+   */
+  void FinishCompressedRead(page_id_t logical_page_id, char *slot, size_t read_size, char *page_data);
+
+  /**
+   * Compress a logical page into the slot it is stored in
+   * @return the number of bytes of slot to write, a multiple of SECTOR_SIZE
+   */
+  size_t EncodeSlot(page_id_t logical_page_id, const char *page_data, char *slot);
+
+  /**
+   * Decompress the slot of a physical page, checking its checksum
+   * @return false if the slot is corrupted, or not a compressed slot
+   */
+  bool DecodeSlot(page_id_t physical_page_id, const char *slot, char *page_data);
+
+  /**
+   * @return whether slot starts with the header of a compressed slot, and if it does its size in slot_size
+   */
+  static bool IsCompressedSlot(const char *slot, size_t &slot_size);
+
+  /**
+   * @return the bytes to read for a logical page according to the page map, PAGE_SIZE if it does not know
+   */
+  size_t GetSlotSizeHint(page_id_t logical_page_id) const;
+
+  /**
+   * Record the slot size of a logical page in the page map.
+   */
+  void SetSlotSizeHint(page_id_t logical_page_id, size_t slot_size);
+
+  /**
+   * Load the page map saved by Close() next to the db file, if there is one and it covers the extents in use.
+   */
+  void LoadSlotMap();
+
+  /**
+   * Save the page map of the extents in use next to the db file.
+   */
+  void SaveSlotMap();
+
+  /**
+   * Read the meta page and build the free extent summary from it.
+   */
+  void ReadMetaPage();
+
+  /**
+   * @return the cached bitmap page of an extent, read from disk on first use
+   */
+  BitmapPage<PAGE_SIZE> *GetBitmap(uint32_t extent_id);
+
+  /**
+   * Record in the free extent summary whether an extent has a free page.
+   */
+  void SetExtentFree(uint32_t extent_id, bool is_free);
+
+  /**
+   * @return the first extent at or after from with a free page, MAX_EXTENTS if there is none
+   */
+  uint32_t FindFreeExtent(uint32_t from = 0) const;
+
+  /**
+   * Start using the extents up to extent_id, if they are not in use yet.
+   */
+  void UseExtent(uint32_t extent_id);
+
+  /**
+   * Reserve room in the db file for the extents from the last one in use up to the first num_extents ones.
+   */
+  void PreallocateExtents(uint32_t num_extents);
+
+  /**
+   * Write the bitmap pages which changed since they were read back to disk.
+   */
+  void FlushBitmaps();
 
   /**
    * Map logical page id to physical page id
    */
   page_id_t MapPageId(page_id_t logical_page_id);
 
+  /** @return whether a slot of a compressed page is read and written alone rather than with the whole page */
+  inline bool UsesPartialSlotIO() const {
+    return UsesFileDescriptor() && !IsReadOnly() && (!direct_io_ || direct_io_block_ < PAGE_SIZE);
+  }
+
+  /** @return size rounded up to what a transfer of the db file must be a multiple of, the direct I/O block */
+  inline size_t RoundToIOBlock(size_t size) const {
+    return direct_io_ ? (size + direct_io_block_ - 1) / direct_io_block_ * direct_io_block_ : size;
+  }
+
+  /**
+   * Account for a page read of size bytes at offset in the bytes the device transferred: exactly those with direct
+   * I/O, otherwise the pages of the page cache they span, which the kernel reads whole
+   */
+  void CountDeviceRead(size_t offset, size_t size);
+
+  /**
+   * @return whether a page buffer must be copied through a bounce buffer, i.e. direct I/O is used and it is not aligned
+   */
+  inline bool NeedsBounce(const void *data) const { return direct_io_ && !IsAligned(data); }
+
+  /**
+   * Lock the file latch for a page read or write if the backend needs it, positional I/O does not
+   */
+  std::unique_lock<std::recursive_mutex> LockForPageIO();
+
+  /** @return whether the db file is accessed through db_fd_ */
+  inline bool UsesFileDescriptor() const { return backend_ != DiskIOBackend::kStream; }
+
+  /**
+   * Put a request into a free slot of the io_uring, waiting for one if needed. Called with async_latch_ held.
+   */
+  void PrepareAsync(bool is_write, page_id_t logical_page_id, char *page_data, size_t length, uint64_t tag);
+
+  /**
+   * Move the completions of the io_uring to async_completed_, waiting until it holds at least min_complete tags or
+   * nothing is in flight. Called with async_latch_ held.
+   */
+  void CollectAsync(size_t min_complete);
+
  private:
-  // stream to write db file
+  DiskIOBackend backend_;
+  // stream to write db file, kStream backend
   std::fstream db_io_;
+  // descriptor of db file, all the other backends
+  int db_fd_{-1};
+  // read-only mapping of db file, kMmap backend
+  char *db_map_{nullptr};
+  size_t db_map_size_{0};
   std::string file_name_;
   // with multiple buffer pool instances, need to protect file access
   std::recursive_mutex db_io_latch_;
   bool closed{false};
-  char meta_data_[PAGE_SIZE];
+  std::atomic<uint64_t> num_reads_{0};
+  std::atomic<uint64_t> num_writes_{0};
+  // db file opened with O_DIRECT
+  bool direct_io_{false};
+  // granularity of the offset and length of direct I/O on the db file, from statx when the kernel reports it
+  size_t direct_io_block_{DIRECT_IO_ALIGNMENT};
+  std::atomic<uint64_t> num_bounced_io_{0};
+  // pages stored compressed
+  bool compressed_{false};
+  alignas(DIRECT_IO_ALIGNMENT) char meta_data_[PAGE_SIZE];
+
+  // bitmap pages by extent, cached on first use, protected by db_io_latch_
+  static constexpr uint32_t MAX_EXTENTS = MAX_VALID_PAGE_ID / BITMAP_SIZE;
+  struct AlignedPage {
+    alignas(DIRECT_IO_ALIGNMENT) char data_[PAGE_SIZE];
+  };
+  std::vector<std::unique_ptr<AlignedPage>> bitmaps_;
+  std::vector<bool> bitmap_dirty_;
+  // bit e of free_extents_ tells whether extent e has a free page, bit w of free_extent_words_ whether word w of
+  // free_extents_ is not zero
+  std::vector<uint64_t> free_extents_;
+  std::vector<uint64_t> free_extent_words_;
+
+  // page map of the compressed pages: slot size in sectors by page, 0 if unknown, for each extent in use. The map of
+  // an extent is created before its first page is allocated and never freed.
+  std::vector<std::unique_ptr<std::atomic<uint8_t>[]>> slot_sectors_;
+  std::atomic<uint64_t> pages_compressed_{0};
+  std::atomic<uint64_t> pages_stored_raw_{0};
+  std::atomic<uint64_t> compress_bytes_in_{0};
+  std::atomic<uint64_t> compress_bytes_out_{0};
+  std::atomic<uint64_t> compress_ns_{0};
+  std::atomic<uint64_t> pages_decompressed_{0};
+  std::atomic<uint64_t> page_bytes_read_{0};
+  std::atomic<uint64_t> device_bytes_read_{0};
+  std::atomic<uint64_t> decompress_ns_{0};
+
+  // asynchronous interface, kIoUring backend
+  struct AsyncRequest {
+    uint64_t tag;
+    page_id_t logical_page_id;
+    char *data;
+    size_t length;
+    bool is_write;
+  };
+  std::unique_ptr<IoUring> io_uring_;
+  std::mutex async_latch_;
+  std::vector<AsyncRequest> async_requests_;  // one slot per request the io_uring can hold
+  std::vector<uint32_t> async_free_slots_;
+  std::vector<uint64_t> async_completed_;     // tags of the completed requests not reaped yet
+  std::vector<std::unique_ptr<AlignedPage>> async_slots_;  // compressed page of a write, by slot
+
+  // decompressed pages handed out by MapPage() from a compressed file, kMmap backend
+  std::mutex map_latch_;
+  std::unordered_map<page_id_t, std::unique_ptr<AlignedPage>> decoded_pages_;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef MINISQL_IO_URING_H
+#define MINISQL_IO_URING_H
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/macros.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+ * IoUring is a minimal wrapper of a Linux io_uring instance, set up with the raw system calls so that no extra
+ * library is needed.
+ *
+ * Requests are prepared in the submission queue and handed to the kernel in batches by Submit(); their results are
+ * popped from the completion queue. The completion queue is twice as large as the submission queue, so it cannot
+ * overflow as long as the caller never has more than GetCapacity() requests prepared or in flight.
+ *
+ * An IoUring is not thread safe, it is driven by one thread at a time.
+ */
+class IoUring {
+ public:
+  /**
+   * Set up a ring of at least entries submission slots. Check IsValid(), the kernel may not support io_uring.
+   */
+  explicit IoUring(unsigned entries);
+
+  ~IoUring();
+
+  DISALLOW_COPY_AND_MOVE(IoUring);
+
+  /** @return whether the ring was set up */
+  inline bool IsValid() const { return ring_fd_ >= 0; }
+
+  /** @return the number of submission slots */
+  inline unsigned GetCapacity() const { return sq_entries_; }
+
+  /** @return the number of requests prepared but not submitted yet */
+  inline unsigned GetNumPrepared() const { return num_prepared_; }
+
+  /**
+   * Prepare a read of len bytes at offset of fd into buf.
+   * @return false if the submission queue is full
+   */
+  bool PrepareRead(int fd, char *buf, size_t len, off_t offset, uint64_t user_data);
+
+  /**
+   * Prepare a write of len bytes of buf at offset of fd.
+   * @return false if the submission queue is full
+   */
+  bool PrepareWrite(int fd, const char *buf, size_t len, off_t offset, uint64_t user_data);
+
+  /**
+   * Submit every prepared request and wait until at least wait_for requests have completed.
+   * @return the number of requests submitted, or -errno
+   */
+  int Submit(unsigned wait_for = 0);
+
+  /**
+   * Pop one completed request without waiting.
+   * @param[out] user_data the user data the request was prepared with
+   * @param[out] result bytes transferred, or -errno
+   * @return false if no request has completed
+   */
+  bool PopCompletion(uint64_t &user_data, int &result);
+
+ private:
+  io_uring_sqe *NextSqe();
+
+  int ring_fd_{-1};
+  unsigned sq_entries_{0};
+  unsigned num_prepared_{0};
+  // submission queue
+  void *sq_ptr_{nullptr};
+  size_t sq_size_{0};
+  unsigned *sq_head_{nullptr};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+  // completion queue, shares the mapping of the submission queue on recent kernels
+  void *cq_ptr_{nullptr};
+  size_t cq_size_{0};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  io_uring_cqe *cqes_{nullptr};
+};
+
+#endif  // MINISQL_IO_URING_H
@@ -0,0 +1,42 @@
+#ifndef MINISQL_PAGE_CODEC_H
+#define MINISQL_PAGE_CODEC_H
+
+#include <cstddef>
+
+/**
+ * PageCodec is a small LZ77 codec in the spirit of LZ4, fast enough to compress every page written to disk.
+ *
+ * The compressed data is a series of sequences, each a token byte followed by literals and a match:
+ * | token | [literal length bytes] | literals | offset (2 bytes) | [match length bytes] |
+ * The high nibble of the token is the number of literals and the low nibble the match length minus MIN_MATCH, a
+ * nibble of 15 being continued by bytes added to it until one is below 255. The match copies match length bytes from
+ * offset bytes back in the output. The last sequence only has literals.
+ *
+ * Matches are found through a hash table of the positions of 4-byte sequences, so the codec needs no memory besides
+ * the table on the stack, and inputs are at most 64KB so that offsets fit in 2 bytes.
+ */
+class PageCodec {
+ public:
+  /**
+   * Compress src into dst.
+   * @param src_size at most MAX_INPUT_SIZE
+   * @return the size of the compressed data, 0 if it does not fit in dst_capacity bytes
+   */
+  static size_t Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity);
+
+  /**
+   * Decompress src into dst, checking that it is well formed.
+   * @return whether src decompressed to exactly dst_size bytes
+   */
+  static bool Decompress(const char *src, size_t src_size, char *dst, size_t dst_size);
+
+  static constexpr size_t MAX_INPUT_SIZE = 65535;
+
+ private:
+  static constexpr size_t MIN_MATCH = 4;
+  // the last bytes of the input are always literals, so that matching never reads past it
+  static constexpr size_t LAST_LITERALS = 5;
+  static constexpr int HASH_BITS = 12;
+};
+
+#endif  // MINISQL_PAGE_CODEC_H
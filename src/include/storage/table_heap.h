@@ -71,6 +71,30 @@ class TableHeap {
    */
   bool GetTuple(Row *row, Txn *txn);
 
+  /**
+   * Read a tuple in place: visitor is called with a RowView of it while its page is pinned and read latched, so the
+   * view must not be kept once visitor returns. Copy out the tuples worth keeping with RowView::Materialize.
+   * @param[in] rid Rid of the tuple
+   * @param[in] visitor callable taking a const RowView &
+   * @return true if the tuple exists, false also if its page could not be fetched
+   */
+  template <typename Visitor>
+  bool VisitTuple(const RowId &rid, [[maybe_unused]] Txn *txn, Visitor &&visitor) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+    if (page == nullptr) {
+      return false;
+    }
+    page->RLatch();
+    RowView view;
+    bool found = page->GetTupleView(rid, schema_, &view);
+    if (found) {
+      visitor(static_cast<const RowView &>(view));
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+    return found;
+  }
+
   void FreeTableHeap() {
     auto next_page_id = first_page_id_;
     while (next_page_id != INVALID_PAGE_ID) {
@@ -89,9 +113,11 @@ class TableHeap {
   void DeleteTable(page_id_t page_id = INVALID_PAGE_ID);
 
   /**
+   * @param bulk_read read the pages of the scan through a private BufferRing, so that a scan of a large table does
+   * not evict the working set of the buffer pool
    * @return the begin iterator of this table
    */
-  TableIterator Begin(Txn *txn);
+  TableIterator Begin(Txn *txn, bool bulk_read = false);
 
   /**
    * @return the end iterator of this table
@@ -114,11 +140,13 @@ class TableHeap {
         log_manager_(log_manager),
         lock_manager_(lock_manager) {
     // ASSERT(false, "Not implemented yet.");
+    // 定宽的schema使用定长的元组格式
+    schema_->CompileFixedLayout(TablePage::SIZE_MAX_ROW);
     //the rest code is to create the first page of the table heap
     page_id_t new_page_id;
-      buffer_pool_manager_->NewPage(new_page_id);
+      // NewPage已经pin住新页，不再FetchPage，否则unpin一次后仍被pin着
+      auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id));
       first_page_id_ = new_page_id;
-      auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(new_page_id));
       new_page->WLatch();
       new_page->Init(new_page_id,INVALID_PAGE_ID,log_manager,txn);
       new_page->SetNextPageId(INVALID_PAGE_ID);
@@ -132,9 +160,21 @@ class TableHeap {
         first_page_id_(first_page_id),
         schema_(schema),
         log_manager_(log_manager),
-        lock_manager_(lock_manager) {}
+        lock_manager_(lock_manager) {
+    // 已有的元组保持原格式，之后写入的元组使用定长格式
+    schema_->CompileFixedLayout(TablePage::SIZE_MAX_ROW);
+  }
 
  private:
+  /**
+   * Append TABLE_HEAP_GROWTH_PAGES empty pages to the heap at once, created by BufferPoolManager::NewPages() so that
+   * their ids, and their pages on disk, are consecutive and a scan reads them in order. Only one page is appended when
+   * the buffer pool cannot pin the whole run.
+   * @param last_page_id the last page of the heap
+   * @return the first appended page, INVALID_PAGE_ID if no page could be created
+   */
+  page_id_t GrowHeap(page_id_t last_page_id, Txn *txn);
+
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
   Schema *schema_;
@@ -1,16 +1,24 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include <deque>
+#include <memory>
+
+#include "buffer/buffer_ring.h"
 #include "common/rowid.h"
 #include "concurrency/txn.h"
 #include "record/row.h"
 
 class TableHeap;
+class TablePage;
 
 class TableIterator {
 public:
  // you may define your own constructor based on your member variables
- explicit TableIterator(TableHeap *table_heap, RowId rid, Txn *txn);
+ /**
+  * @param ring buffer ring the pages of the scan are read through, shared by the copies of the iterator
+  */
+ explicit TableIterator(TableHeap *table_heap, RowId rid, Txn *txn, std::shared_ptr<BufferRing> ring = nullptr);
 
  explicit TableIterator(const TableIterator &other);
 
@@ -30,10 +38,27 @@ public:
 
   TableIterator operator++(int);
 
+  /** @return the rid of the row the iterator is on, without reading the row */
+  inline RowId GetRowId() const { return currentRowID_; }
+
 private:
+  /**
+   * Keep DEFAULT_READ_AHEAD_PAGES pages of the page chain in flight in front of the cursor, at most half the frames
+   * of the ring of the scan. Runs when the cursor moves to another page. The chain can only be followed through pages
+   * which are already resident, so each step extends it as far as the previous reads got.
+   * @param page the page the cursor is on, pinned by the caller
+   */
+  void ReadAhead(TablePage *page);
+
+  /** @return the page after page_id in the chain, INVALID_PAGE_ID if page_id is not readable yet */
+  page_id_t NextResidentPageId(page_id_t page_id);
+
   // add your own private member variables here
   TableHeap* tableHeap_; // 指向TableHeap对象的指针
   RowId currentRowID_;   // 当前行的RowID
+  std::shared_ptr<BufferRing> ring_;  // 顺序扫描的buffer ring，可以为空
+  page_id_t read_ahead_page_{INVALID_PAGE_ID};  // 上一次预读时游标所在的page
+  std::deque<page_id_t> read_ahead_;            // 已预读、游标尚未到达的page，按链表顺序
 };
 
 #endif  // MINISQL_TABLE_ITERATOR_H
@@ -25,9 +25,9 @@ BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager
     LOG(ERROR) << "Failed to fetch root page";
     return;
   }
-  auto index_root_page = reinterpret_cast<IndexRootsPage *>(root_page);//将根节点转换为索引根节点
+  auto index_root_page = reinterpret_cast<IndexRootsPage *>(root_page->GetData());//将根节点转换为索引根节点
   index_root_page->GetRootId(index_id_, &root_page_id_);//获取根节点的ID，赋值给根节点ID
-  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);//解锁根节点
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);//只读了根节点，不是脏页
   if(leaf_max_size_ == UNDEFINED_SIZE) {//如果叶子节点的最大大小未定义
     leaf_max_size_ = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (processor_.GetKeySize() + sizeof(RowId));//叶子节点的最大大小为（页大小-叶子节点头部大小）/（处理器的长度+RowId的大小）
   }
@@ -38,7 +38,7 @@ BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager
 }
 
 void BPlusTree::Destroy(page_id_t current_page_id) {
-    if (root_page_id_ == INVALID_PAGE_ID) {
+    if (root_page_id_ == INVALID_PAGE_ID || buffer_pool_manager_->IsReadOnly()) {
         return;
     }
     if (current_page_id == INVALID_PAGE_ID) {
@@ -104,6 +104,7 @@ bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Txn
  * just use insertleaf to do this
  */
 bool BPlusTree::Insert(GenericKey *key, const RowId &value, Txn *transaction) {
+  if(buffer_pool_manager_->IsReadOnly()) return false;//只读映射的页不能写
   if(IsEmpty())
   {StartNewTree(key,value);return 1;}
   // cout << "Not empty" << endl;
@@ -260,6 +261,7 @@ void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlus
  * necessary.
  */
 void BPlusTree::Remove(const GenericKey *key, Txn *transaction) {
+  if(buffer_pool_manager_->IsReadOnly()) return;
   //如果B+树为空
   if(IsEmpty())return;
   //找到叶子节点
@@ -273,7 +275,7 @@ void BPlusTree::Remove(const GenericKey *key, Txn *transaction) {
   else if(index ==0)//为叶节点的第一个key
   {
     Page *parent_page = buffer_pool_manager_->FetchPage(leaf->GetParentPageId());
-    auto parent = reinterpret_cast<InternalPage *>(parent_page);
+    auto parent = parent_page == nullptr ? nullptr : reinterpret_cast<InternalPage *>(parent_page->GetData());
     page_id_t value = leaf->GetPageId();
     if(parent_page!=nullptr)
     {
@@ -281,7 +283,7 @@ void BPlusTree::Remove(const GenericKey *key, Txn *transaction) {
       {
         value = parent->GetPageId();
         parent_page = buffer_pool_manager_->FetchPage(parent->GetParentPageId());
-        parent = reinterpret_cast<InternalPage *>(parent_page);
+        parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
         buffer_pool_manager_->UnpinPage(parent->GetPageId(),false);
       }
       if(parent->ValueIndex(value)!=0 && processor_.CompareKeys(leaf->KeyAt(0), parent->KeyAt(parent->ValueIndex(value))) != 0)
@@ -326,7 +328,7 @@ bool BPlusTree::CoalesceOrRedistribute(N *&node, Txn *transaction) {
         auto child_internal = reinterpret_cast<InternalPage *>(node);
         page_id_t child_id = child_internal->LeftMostKey(buffer_pool_manager_);
         Page * leaf_page = buffer_pool_manager_->FetchPage(child_id);
-        auto leaf = reinterpret_cast<LeafPage *>(leaf_page);
+        auto leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
         parent->SetKeyAt(index, leaf->KeyAt(0));
         buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
       }
@@ -347,7 +349,7 @@ bool BPlusTree::CoalesceOrRedistribute(N *&node, Txn *transaction) {
         auto child_internal = reinterpret_cast<InternalPage *>(node);
         page_id_t child_id = child_internal->LeftMostKey(buffer_pool_manager_);
         Page * leaf_page = buffer_pool_manager_->FetchPage(child_id);
-        auto leaf = reinterpret_cast<LeafPage *>(leaf_page);
+        auto leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
         parent->SetKeyAt(index, leaf->KeyAt(0));
         buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
       }
@@ -518,7 +520,7 @@ IndexIterator BPlusTree::Begin(const GenericKey *key) {
    Page * left_most_page = FindLeafPage(key, INVALID_PAGE_ID, false);
   page_id_t page_id = left_most_page->GetPageId();
   if(left_most_page == nullptr)return IndexIterator();
-  auto * leaf = reinterpret_cast<BPlusTree::LeafPage *>(left_most_page);
+  auto * leaf = reinterpret_cast<BPlusTree::LeafPage *>(left_most_page->GetData());
   buffer_pool_manager_->UnpinPage(page_id, false);
   return IndexIterator(page_id, buffer_pool_manager_,leaf->KeyIndex(key, processor_));
 }
@@ -549,7 +551,7 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
 
   while (Page_tmp_treenode->IsLeafPage()==0) {
     buffer_pool_manager_->UnpinPage(Page_id_tmp, false);  // 每找一层关闭上一层的内节点page
-    auto *internalPage = reinterpret_cast<BPlusTree::InternalPage *>(Page_tmp);  // 打开上一层内节点page
+    auto *internalPage = reinterpret_cast<BPlusTree::InternalPage *>(Page_tmp->GetData());  // 打开上一层内节点page
     if (leftMost)Page_id_tmp = internalPage->ValueAt(0);//如果leftMost为true,则找到最左边的叶子节点
     else Page_id_tmp = internalPage->Lookup(key, processor_);//否则根据key找到对应的孩子
 
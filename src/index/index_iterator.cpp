@@ -2,6 +2,7 @@
 
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "page/b_plus_tree_internal_page.h"
 
 IndexIterator::IndexIterator() = default;//默认构造函数
 
@@ -11,6 +12,7 @@ IndexIterator::IndexIterator() = default;//默认构造函数
 IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index)
     : current_page_id(page_id), item_index(index), buffer_pool_manager(bpm) {
   page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
+  ReadAhead();
 }
 
 IndexIterator::~IndexIterator() {
@@ -29,13 +31,15 @@ IndexIterator &IndexIterator::operator++() {
     int next_id = page->GetNextPageId();
     //unpin上一个page
     buffer_pool_manager->UnpinPage(page->GetPageId(), false);
-    page = reinterpret_cast<IndexIterator::LeafPage *>(buffer_pool_manager->FetchPage(next_id));
+    Page *next_page = buffer_pool_manager->FetchPage(next_id);
+    page = next_page == nullptr ? nullptr : reinterpret_cast<IndexIterator::LeafPage *>(next_page->GetData());
 //    if(page== nullptr){
 //      auto end = new IndexIterator;
 //      return *end;
 //    }
     item_index = 0;
     current_page_id = next_id;
+    if(page != nullptr) ReadAhead();
   }
   return *this;
 }
@@ -46,4 +50,34 @@ bool IndexIterator::operator==(const IndexIterator &itr) const {
 
 bool IndexIterator::operator!=(const IndexIterator &itr) const {
   return !(*this == itr);
-}
\ No newline at end of file
+}
+
+void IndexIterator::ReadAhead() {
+  if (!buffer_pool_manager->IsPrefetching()) {
+    return;
+  }
+  // forget the leaves up to the cursor, everything if the cursor left the leaves we were reading
+  while (!read_ahead.empty() && read_ahead.front() != current_page_id) {
+    read_ahead.pop_front();
+  }
+  if (!read_ahead.empty()) {
+    read_ahead.pop_front();
+  }
+  if (read_ahead.size() >= DEFAULT_READ_AHEAD_PAGES / 2 || page->GetParentPageId() == INVALID_PAGE_ID) {
+    return;
+  }
+  Page *parent_page = buffer_pool_manager->FetchPage(page->GetParentPageId());
+  if (parent_page == nullptr) {
+    return;
+  }
+  auto parent = reinterpret_cast<BPlusTreeInternalPage *>(parent_page->GetData());
+  std::vector<page_id_t> page_ids;
+  // the leaves of the next parent are asked for once the cursor gets there
+  int index = parent->IsLeafPage() ? -1 : parent->ValueIndex(read_ahead.empty() ? current_page_id : read_ahead.back());
+  for (int i = index + 1; index >= 0 && i < parent->GetSize() && read_ahead.size() < DEFAULT_READ_AHEAD_PAGES; i++) {
+    page_ids.push_back(parent->ValueAt(i));
+    read_ahead.push_back(parent->ValueAt(i));
+  }
+  buffer_pool_manager->UnpinPage(parent_page->GetPageId(), false);
+  buffer_pool_manager->PrefetchPages(page_ids);
+}
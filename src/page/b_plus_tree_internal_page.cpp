@@ -272,7 +272,7 @@ page_id_t InternalPage::LeftMostKey(BufferPoolManager *buffer_pool_manager){
   InternalPage * intPage;
   while(inPage->IsLeafPage()!=true){
     buffer_pool_manager->UnpinPage(page->GetPageId(), false); //unpin page
-    intPage = reinterpret_cast<InternalPage *>(page);
+    intPage = reinterpret_cast<InternalPage *>(page->GetData());
     page = buffer_pool_manager->FetchPage(intPage->ValueAt(0));
     inPage = reinterpret_cast<InternalPage *>(page->GetData());//转换成InternalPage
   }
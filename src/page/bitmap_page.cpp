@@ -1,137 +1,125 @@
 #include "page/bitmap_page.h"
 
+#include <cstring>
+
 #include "glog/logging.h"
 
-/**
- * TODO: Student Implement
- */
 template <size_t PageSize>
 bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
+  if (page_allocated_ >= GetMaxSupportedSize()) {
+    return false;
+  }
+  // next_free_page_记录最小的空闲页；旧版本写入的位图可能不满足，此时从它往后找
+  page_offset = IsPageFree(next_free_page_) ? next_free_page_ : FindFreePage(next_free_page_);
+  bytes[page_offset / 8] |= static_cast<unsigned char>(0x80 >> (page_offset % 8));
+  page_allocated_++;
+  if (page_allocated_ < GetMaxSupportedSize()) {
+    next_free_page_ = FindFreePage(page_offset + 1);
+  }
+  return true;
+}
 
-  if (page_allocated_ == MAX_CHARS*8)
-    {
-        return false;
-    } else {
-        // 分配下一个空闲的数据页
-        page_offset = next_free_page_;
-        // 已经分配的数据页数目加 1
-        page_allocated_++;
-
-        /*
-         * 更改位图中的信息，将记录中对应的 位 置为 1
-         */
-
-        // 获取位关于对应字节的偏移量
-        int offset = next_free_page_ % 8;
-
-        // 将 temp 中对应的位置为 1
-        unsigned char temp = 1 << (7 - offset);
-
-        // 将位所在的字节与 temp 进行或运算，从而实现将对应的位置为 1
-        bytes[next_free_page_ / 8] |= temp;
-
-        /*
-         * 接下来寻找下一个未分配的页
-         */
-
-        if (page_allocated_ == MAX_CHARS*8)
-        {
-            // 表明当前已经不存在未分配的页
-
-        } else {
-            for (unsigned int i = 0; i < MAX_CHARS; i++)
-            {
-                bool flag = false;  // 记录在当前字节是否存在未分配的页
-                temp = 0b10000000;
-                for (int j = 0; j < 8; j++)
-                {
-                    if ((bytes[i] & temp) == 0)
-                    {
-                        // 表明当前位的值为 0，即存在一个未分配的页
-                        flag = true;
-                        next_free_page_ = i * 8 + j;
-                        break;
-                    } else {
-                        temp >>= 1;
-                    }
-                }
-
-                if (flag)
-                {
-                    // 在当前字节存在未分配的页，循环结束
-                    break;
-                }
-            }
-        }
-
-        // 返回申请空间成功的信息
-        return true;
+template <size_t PageSize>
+bool BitmapPage<PageSize>::AllocatePages(uint32_t num_pages, uint32_t &page_offset) {
+  if (num_pages == 0 || num_pages > GetMaxSupportedSize() - page_allocated_) {
+    return false;
+  }
+  // 依次检查每一段连续的空闲页，直到找到足够长的一段
+  uint32_t start = IsPageFree(next_free_page_) ? next_free_page_ : FindFreePage(next_free_page_);
+  while (true) {
+    uint32_t end = FindAllocatedPage(start);
+    if (end - start >= num_pages) {
+      break;
+    }
+    if (end >= GetMaxSupportedSize()) {
+      return false;
+    }
+    uint32_t next = FindFreePage(end);
+    if (next <= start) {
+      return false;  // 绕回到了开头，没有足够长的一段
     }
+    start = next;
+  }
+  for (uint32_t i = start; i < start + num_pages; i++) {
+    bytes[i / 8] |= static_cast<unsigned char>(0x80 >> (i % 8));
+  }
+  page_allocated_ += num_pages;
+  if (page_allocated_ < GetMaxSupportedSize() && start == next_free_page_) {
+    next_free_page_ = FindFreePage(start + num_pages);
+  }
+  page_offset = start;
+  return true;
 }
 
-/**
- * TODO: Student Implement
- */
 template <size_t PageSize>
 bool BitmapPage<PageSize>::DeAllocatePage(uint32_t page_offset) {
-  // 1. Check if the page is already free
-  if (IsPageFree(page_offset)) {
+  if (page_offset >= GetMaxSupportedSize() || IsPageFree(page_offset)) {
     return false;
   }
-  if (page_offset >= MAX_CHARS*8)
-    {
-        return false;
-    }
-
-    // 2. Deallocate the page
-    // 获取位关于对应字节的偏移量
-    unsigned int offset = page_offset % 8;
-
-    // 将 temp 中对应的位置为 1
-    unsigned char temp = 1 << (7 - offset);
-
-    // 按位取反
-    temp = ~temp;
+  bytes[page_offset / 8] &= static_cast<unsigned char>(~(0x80 >> (page_offset % 8)));
+  // 保持next_free_page_为最小的空闲页，下次分配不需要查找
+  if (page_allocated_ == GetMaxSupportedSize() || page_offset < next_free_page_) {
+    next_free_page_ = page_offset;
+  }
+  page_allocated_--;
+  return true;
+}
 
-    // 将对应的位置为 0
-    bytes[page_offset / 8] &= temp;
+template <size_t PageSize>
+bool BitmapPage<PageSize>::IsPageFree(uint32_t page_offset) const {
+  if (page_offset >= GetMaxSupportedSize()) {
+    return false;
+  }
+  return IsPageFreeLow(page_offset / 8, page_offset % 8);
+}
 
-    if (page_allocated_ == 8 * MAX_CHARS)
-    {
-        // 表明删除之前数据页已经全部被分配，不存在空页
-        // 删除之后要更新空页的位置
-        next_free_page_ = page_offset;
-    }
+template <size_t PageSize>
+bool BitmapPage<PageSize>::IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const {
+  return (bytes[byte_index] & (0x80 >> bit_index)) == 0;
+}
 
-    // 数据页分配数量减 1
-    page_allocated_ --;
-    // 返回删除成功的信息
-    return true;
+template <size_t PageSize>
+uint64_t BitmapPage<PageSize>::LoadWord(size_t word_index) const {
+  uint64_t word;
+  memcpy(&word, bytes + word_index * 8, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif
+  return word;
 }
 
-/**
- * TODO: Student Implement
- */
 template <size_t PageSize>
-bool BitmapPage<PageSize>::IsPageFree(uint32_t page_offset) const {
-  if(page_offset >= MAX_CHARS*8)
-    {
-        return false;
-    } else {
-        // 获取位关于对应字节的偏移量
-        int offset = page_offset % 8;
-
-        // 将 temp 中对应的位置为 1
-        unsigned char temp = 1 << (7 - offset);
-
-        // 将位所在的字节与 temp 进行与运算，从而实现将对应的位置为 1
-        return (bytes[page_offset / 8] & temp) == 0;
+uint32_t BitmapPage<PageSize>::FindFreePage(uint32_t from) const {
+  // 页i对应第i/64个字的第63-i%64位，所以字中最靠前的空闲页就是取反后的前导零个数
+  size_t start_word = (from % GetMaxSupportedSize()) / 64;
+  uint64_t skip = ~0ULL >> (from % GetMaxSupportedSize() % 64);
+  for (size_t i = 0; i <= NUM_WORDS; i++) {
+    size_t word_index = (start_word + i) % NUM_WORDS;
+    uint64_t free_bits = ~LoadWord(word_index);
+    if (i == 0) {
+      free_bits &= skip;  // 起始字中from之前的页留到绕回来时再看
     }
+    if (free_bits != 0) {
+      return static_cast<uint32_t>(word_index * 64 + __builtin_clzll(free_bits));
+    }
+  }
+  return GetMaxSupportedSize();
 }
 
 template <size_t PageSize>
-bool BitmapPage<PageSize>::IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const {
-  return false;
+uint32_t BitmapPage<PageSize>::FindAllocatedPage(uint32_t from) const {
+  if (from >= GetMaxSupportedSize()) {
+    return GetMaxSupportedSize();
+  }
+  size_t word_index = from / 64;
+  uint64_t used_bits = LoadWord(word_index) & (~0ULL >> (from % 64));
+  while (used_bits == 0) {
+    if (++word_index >= NUM_WORDS) {
+      return GetMaxSupportedSize();
+    }
+    used_bits = LoadWord(word_index);
+  }
+  return static_cast<uint32_t>(word_index * 64 + __builtin_clzll(used_bits));
 }
 
 template class BitmapPage<64>;
@@ -146,4 +134,10 @@ template class BitmapPage<1024>;
 
 template class BitmapPage<2048>;
 
-template class BitmapPage<4096>;
\ No newline at end of file
+template class BitmapPage<4096>;
+
+template class BitmapPage<8192>;
+
+template class BitmapPage<16384>;
+
+template class BitmapPage<32768>;
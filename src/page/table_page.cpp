@@ -164,6 +164,15 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Txn *txn, LockManager *lock_m
   return true;
 }
 
+bool TablePage::GetTupleView(const RowId &rid, const Schema *schema, RowView *view) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || IsDeleted(GetTupleSize(slot_num))) {
+    return false;
+  }
+  view->Reset(GetData() + GetTupleOffsetAtSlot(slot_num), schema, rid);
+  return true;
+}
+
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
@@ -0,0 +1,37 @@
+#include "record/field_comparator.h"
+
+namespace {
+
+template <TypeId type>
+constexpr FieldComparator field_comparators[] = {
+    CompareFields<type, CompareOp::kEquals>,        CompareFields<type, CompareOp::kNotEquals>,
+    CompareFields<type, CompareOp::kLessThan>,      CompareFields<type, CompareOp::kLessThanEquals>,
+    CompareFields<type, CompareOp::kGreaterThan>,   CompareFields<type, CompareOp::kGreaterThanEquals>};
+
+}  // namespace
+
+FieldComparator GetFieldComparator(TypeId type, CompareOp op) {
+  switch (type) {
+    case TypeId::kTypeInt:
+      return field_comparators<TypeId::kTypeInt>[static_cast<int>(op)];
+    case TypeId::kTypeFloat:
+      return field_comparators<TypeId::kTypeFloat>[static_cast<int>(op)];
+    case TypeId::kTypeChar:
+      return field_comparators<TypeId::kTypeChar>[static_cast<int>(op)];
+    default:
+      return nullptr;
+  }
+}
+
+ViewFieldComparator GetViewFieldComparator(TypeId type) {
+  switch (type) {
+    case TypeId::kTypeInt:
+      return CompareViewFields<TypeId::kTypeInt>;
+    case TypeId::kTypeFloat:
+      return CompareViewFields<TypeId::kTypeFloat>;
+    case TypeId::kTypeChar:
+      return CompareViewFields<TypeId::kTypeChar>;
+    default:
+      return nullptr;
+  }
+}
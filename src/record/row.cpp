@@ -8,6 +8,9 @@
 uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(schema->GetColumnCount() == fields_.size(), "Fields size do not match schema's column size.");
+  if (FitsFixedLayout(schema)) {
+    return SerializeFixedTo(buf, schema);
+  }
 
   uint32_t offset = 0;
   //写入magic number
@@ -39,18 +42,20 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
   uint32_t field_count;
   memcpy(&field_count, buf + offset, sizeof(field_count));//读取field的数量
   offset += sizeof(field_count);
+  if (field_count & FIXED_FORMAT_FLAG) {
+    return DeserializeFixedFrom(buf, schema, field_count & ~FIXED_FORMAT_FLAG);
+  }
 
   char * field_buf = buf + offset;
   uint32_t field_offset = (field_count + 7)/8;
   offset += field_offset;
   fields_.clear();fields_.resize(field_count, nullptr);
   for(uint32_t i=0; i<field_count; i++){
-    if(field_buf[i/8] & (1 << (i%8)))//
-    {
-      offset += Field::DeserializeFrom(offset+buf,schema->GetColumns()[i]->GetType(),&fields_[i], true);
-    }
-    else {
-      offset += Field::DeserializeFrom(offset+buf,schema->GetColumns()[i]->GetType(),&fields_[i], false);
+    TypeId type = schema->GetColumns()[i]->GetType();
+    bool is_null = field_buf[i/8] & (1 << (i%8));
+    fields_[i] = ReadField(type, buf + offset, is_null);
+    if (!is_null) {
+      offset += type == TypeId::kTypeChar ? sizeof(uint32_t) + MACH_READ_UINT32(buf + offset) : Type::GetTypeSize(type);
     }
   }
   return offset;
@@ -59,6 +64,9 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
 uint32_t Row::GetSerializedSize(Schema *schema) const {
   ASSERT(schema != nullptr, "Invalid schema before serialize.");
   ASSERT(schema->GetColumnCount() == fields_.size(), "Fields size do not match schema's column size.");
+  if (FitsFixedLayout(schema)) {
+    return schema->GetFixedRowSize();
+  }
   uint32_t size = 0;
   uint32_t field_count = fields_.size();
   size += sizeof(field_count);
@@ -70,12 +78,99 @@ uint32_t Row::GetSerializedSize(Schema *schema) const {
 }
 
 void Row::GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key_row) {
-  auto columns = key_schema->GetColumns();
-  std::vector<Field> fields;
+  //键的field直接复制到key_row中（及其heap中）
+  key_row.destroy();
+  key_row.rid_ = RowId();
   uint32_t idx;
-  for (auto column : columns) {
+  for (auto column : key_schema->GetColumns()) {
     schema->GetColumnIndex(column->GetName(), idx);
-    fields.emplace_back(*this->GetField(idx));
+    key_row.AppendField(*this->GetField(idx));
+  }
+}
+
+bool Row::FitsFixedLayout(const Schema *schema) const {
+  if (!schema->HasFixedLayout()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < fields_.size(); i++) {
+    const Field *field = fields_[i];
+    if (field != nullptr && !field->is_null_ && field->type_id_ == TypeId::kTypeChar &&
+        field->len_ > schema->GetColumn(i)->GetLength()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//定长格式：每个field按schema给出的偏移直接写入，null的field也占位
+uint32_t Row::SerializeFixedTo(char *buf, const Schema *schema) const {
+  uint32_t row_size = schema->GetFixedRowSize();
+  memset(buf, 0, row_size);
+  uint32_t field_count = fields_.size();
+  MACH_WRITE_UINT32(buf, field_count | FIXED_FORMAT_FLAG);
+  char *null_bitmap = buf + sizeof(uint32_t);
+  for (uint32_t i = 0; i < field_count; i++) {
+    const Field *field = fields_[i];
+    if (field == nullptr || field->is_null_) {
+      null_bitmap[i / 8] |= (1 << (i % 8));
+      continue;
+    }
+    char *field_buf = buf + schema->GetFixedOffset(i);
+    if (field->type_id_ == TypeId::kTypeChar) {
+      MACH_WRITE_UINT32(field_buf, field->len_);
+      memcpy(field_buf + sizeof(uint32_t), field->GetChars(), field->len_);
+    } else {
+      memcpy(field_buf, &field->value_, sizeof(int32_t));
+    }
+  }
+  return row_size;
+}
+
+uint32_t Row::DeserializeFixedFrom(const char *buf, const Schema *schema, uint32_t field_count) {
+  ASSERT(schema->HasFixedLayout() && field_count == schema->GetColumnCount(), "Row is not in the schema's layout.");
+  const char *null_bitmap = buf + sizeof(uint32_t);
+  fields_.resize(field_count, nullptr);
+  for (uint32_t i = 0; i < field_count; i++) {
+    bool is_null = null_bitmap[i / 8] & (1 << (i % 8));
+    fields_[i] = ReadField(schema->GetColumn(i)->GetType(), buf + schema->GetFixedOffset(i), is_null);
+  }
+  return schema->GetFixedRowSize();
+}
+
+Field *Row::NewField(const Field &field) const {
+  if (heap_ != nullptr && field.type_id_ == TypeId::kTypeChar && !field.is_null_) {
+    char *chars = const_cast<char *>(field.GetChars());
+    if (field.len_ <= Field::INLINE_CHARS) {
+      //短字符串存在field内，不占heap
+      return MakeField(TypeId::kTypeChar, chars, field.len_, true);
+    }
+    //CHAR的数据也放进heap，field不再管理它
+    char *copy = static_cast<char *>(heap_->Allocate(field.len_));
+    memcpy(copy, chars, field.len_);
+    return MakeField(TypeId::kTypeChar, copy, field.len_, false);
+  }
+  return MakeField(field);
+}
+
+Field *Row::ReadField(TypeId type, const char *buf, bool is_null) const {
+  if (is_null) {
+    return MakeField(type);
+  }
+  switch (type) {
+    case TypeId::kTypeInt:
+      return MakeField(type, MACH_READ_INT32(buf));
+    case TypeId::kTypeFloat:
+      return MakeField(type, MACH_READ_FROM(float, buf));
+    case TypeId::kTypeChar: {
+      uint32_t len = MACH_READ_UINT32(buf);
+      char *chars = const_cast<char *>(buf) + sizeof(uint32_t);
+      if (heap_ == nullptr) {
+        return MakeField(type, chars, len, true);
+      }
+      return NewField(Field(type, chars, len, false));
+    }
+    default:
+      break;
   }
-  key_row = Row(fields);
+  throw "Unknown field type.";
 }
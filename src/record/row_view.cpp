@@ -0,0 +1,97 @@
+#include "record/row_view.h"
+
+void RowView::Reset(const char *data, const Schema *schema, RowId rid) {
+  ASSERT(schema != nullptr, "Invalid schema before deserialize.");
+  data_ = data;
+  schema_ = schema;
+  rid_ = rid;
+  field_count_ = MACH_READ_UINT32(data);
+  fixed_ = (field_count_ & Row::FIXED_FORMAT_FLAG) != 0;
+  field_count_ &= ~Row::FIXED_FORMAT_FLAG;
+  ASSERT(field_count_ == schema->GetColumnCount(), "Fields size do not match schema's column size.");
+  null_bitmap_ = data + sizeof(uint32_t);
+  cursor_idx_ = 0;
+  cursor_offset_ = sizeof(uint32_t) + (field_count_ + 7) / 8;
+}
+
+const char *RowView::FieldData(uint32_t idx) const {
+  ASSERT(!IsNull(idx), "Null field has no data.");
+  if (fixed_) {
+    return data_ + schema_->GetFixedOffset(idx);
+  }
+  // 往回访问时从第一个field重新开始
+  if (idx < cursor_idx_) {
+    cursor_idx_ = 0;
+    cursor_offset_ = sizeof(uint32_t) + (field_count_ + 7) / 8;
+  }
+  const auto &columns = schema_->GetColumns();
+  while (cursor_idx_ < idx) {
+    if (!IsNull(cursor_idx_)) {
+      TypeId type = columns[cursor_idx_]->GetType();
+      cursor_offset_ += type == TypeId::kTypeChar ? sizeof(uint32_t) + MACH_READ_UINT32(data_ + cursor_offset_)
+                                                  : Type::GetTypeSize(type);
+    }
+    cursor_idx_++;
+  }
+  return data_ + cursor_offset_;
+}
+
+const char *RowView::GetChars(uint32_t idx, uint32_t *len) const {
+  const char *buf = FieldData(idx);
+  *len = MACH_READ_UINT32(buf);
+  return buf + sizeof(uint32_t);
+}
+
+Field RowView::GetField(uint32_t idx) const {
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  if (IsNull(idx)) {
+    return Field(type);
+  }
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, GetInt(idx));
+    case TypeId::kTypeFloat:
+      return Field(type, GetFloat(idx));
+    case TypeId::kTypeChar: {
+      uint32_t len;
+      const char *chars = GetChars(idx, &len);
+      return Field(type, const_cast<char *>(chars), len, false);
+    }
+    default:
+      break;
+  }
+  throw "Unknown field type.";
+}
+
+Field *RowView::CopyField(const Row *row, uint32_t idx) const {
+  if (row->GetMemHeap() != nullptr) {
+    return row->NewField(GetField(idx));
+  }
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  if (type == TypeId::kTypeChar && !IsNull(idx)) {
+    uint32_t len;
+    const char *chars = GetChars(idx, &len);
+    return new Field(type, const_cast<char *>(chars), len, true);
+  }
+  return new Field(GetField(idx));
+}
+
+void RowView::Materialize(Row *row) const {
+  row->destroy();
+  row->SetRowId(rid_);
+  auto &fields = row->GetFields();
+  fields.reserve(field_count_);
+  for (uint32_t i = 0; i < field_count_; i++) {
+    fields.push_back(CopyField(row, i));
+  }
+}
+
+void RowView::Materialize(Row *row, const std::vector<uint32_t> &column_ids) const {
+  row->destroy();
+  row->SetRowId(rid_);
+  auto &fields = row->GetFields();
+  fields.reserve(column_ids.size());
+  for (auto idx : column_ids) {
+    fields.push_back(CopyField(row, idx));
+  }
+}
@@ -50,4 +50,39 @@ uint32_t Schema::DeserializeFrom(char *buf, Schema *&schema) {
   }
   schema = new Schema(columns, 1);
   return offset;
-}
\ No newline at end of file
+}
+
+bool Schema::CompileFixedLayout(uint32_t max_row_size) {
+  fixed_offsets_.clear();
+  fixed_row_size_ = 0;
+  if (columns_.empty()) {
+    return false;
+  }
+  std::vector<uint32_t> offsets;
+  offsets.reserve(columns_.size());
+  // 行头与变长格式相同：field数量和null位图
+  uint32_t offset = sizeof(uint32_t) + (GetColumnCount() + 7) / 8;
+  for (const auto column : columns_) {
+    offsets.push_back(offset);
+    switch (column->GetType()) {
+      case TypeId::kTypeInt:
+      case TypeId::kTypeFloat:
+        offset += Type::GetTypeSize(column->GetType());
+        break;
+      case TypeId::kTypeChar:
+        if (column->GetLength() == 0) {
+          return false;
+        }
+        offset += sizeof(uint32_t) + column->GetLength();  // 长度和按声明长度预留的字符
+        break;
+      default:
+        return false;
+    }
+  }
+  if (offset > max_row_size) {
+    return false;
+  }
+  fixed_offsets_ = std::move(offsets);
+  fixed_row_size_ = offset;
+  return true;
+}
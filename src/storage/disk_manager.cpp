@@ -1,15 +1,110 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
 #include <filesystem>
+#include <fstream>
 #include <stdexcept>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
+#include "storage/page_codec.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+// 压缩页的槽以这个头开始，后面是压缩后的数据，按扇区补齐
+struct SlotHeader {
+  uint32_t magic;
+  uint32_t checksum;  // 压缩数据的校验和，以物理页号为种子
+  uint16_t length;    // 压缩数据的长度
+  uint16_t reserved;
+};
+
+static constexpr uint32_t SLOT_MAGIC = 0x5a51534d;  // "MSQZ"
+
+static uint32_t SlotChecksum(page_id_t physical_page_id, const char *data, size_t length) {
+  // FNV-1a
+  uint32_t hash = 2166136261U ^ static_cast<uint32_t>(physical_page_id);
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619U;
+  }
+  return hash;
+}
+
+// 与数据库文件放在一起，记录压缩页的槽大小
+static std::string SlotMapFileName(const std::string &db_file) { return db_file + ".slots"; }
+
+DiskManager::DiskManager(const std::string &db_file, DiskIOBackend backend, bool direct_io, bool compress)
+    : backend_(backend), file_name_(db_file), compressed_(compress) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (direct_io && backend != DiskIOBackend::kPread && backend != DiskIOBackend::kIoUring) {
+    LOG(WARNING) << "Direct I/O is only supported by the pread and io_uring backends, ignored";
+    direct_io = false;
+  }
+  if (IsReadOnly()) {
+    // 只读打开已有的文件，整个映射到内存
+    db_fd_ = open(db_file.c_str(), O_RDONLY);
+    struct stat stat_buf;
+    if (db_fd_ < 0 || fstat(db_fd_, &stat_buf) != 0) {
+      throw std::exception();
+    }
+    db_map_size_ = stat_buf.st_size;
+    if (db_map_size_ > 0) {
+      void *map = mmap(nullptr, db_map_size_, PROT_READ, MAP_SHARED, db_fd_, 0);
+      if (map == MAP_FAILED) {
+        close(db_fd_);
+        throw std::exception();
+      }
+      db_map_ = static_cast<char *>(map);
+    }
+    ReadMetaPage();
+    return;
+  }
+  if (UsesFileDescriptor()) {
+    std::filesystem::path p = db_file;
+    if (p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | (direct_io ? O_DIRECT : 0), 0644);
+    direct_io_ = direct_io && db_fd_ >= 0;
+    if (direct_io && db_fd_ < 0 && errno == EINVAL) {
+      // 文件系统不支持O_DIRECT，退回到经过页缓存的读写
+      LOG(WARNING) << "Direct I/O is not supported for " << db_file << ", falling back to buffered I/O";
+      db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+    }
+    if (db_fd_ < 0) {
+      throw std::exception();
+    }
+#ifdef STATX_DIOALIGN
+    // 直接I/O的对齐要求通常是一个扇区，压缩页的槽可以只读写它占用的扇区
+    struct statx stx;
+    if (direct_io_ && statx(db_fd_, "", AT_EMPTY_PATH, STATX_DIOALIGN, &stx) == 0 &&
+        (stx.stx_mask & STATX_DIOALIGN) != 0 && stx.stx_dio_mem_align <= DIRECT_IO_ALIGNMENT &&
+        stx.stx_dio_offset_align > 0 && PAGE_SIZE % stx.stx_dio_offset_align == 0) {
+      direct_io_block_ = std::max<size_t>(stx.stx_dio_offset_align, SECTOR_SIZE);
+    }
+#endif
+    if (backend_ == DiskIOBackend::kIoUring) {
+      io_uring_ = std::make_unique<IoUring>(DEFAULT_IO_URING_DEPTH);
+      if (!io_uring_->IsValid()) {
+        LOG(WARNING) << "io_uring is not available, falling back to synchronous I/O";
+        io_uring_.reset();
+        backend_ = DiskIOBackend::kPread;
+      } else {
+        async_requests_.resize(io_uring_->GetCapacity());
+        async_slots_.resize(io_uring_->GetCapacity());
+        for (uint32_t slot = io_uring_->GetCapacity(); slot > 0; slot--) {
+          async_free_slots_.push_back(slot - 1);
+        }
+      }
+    }
+    ReadMetaPage();
+    return;
+  }
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
   // directory or file does not exist
   if (!db_io_.is_open()) {
@@ -25,122 +120,653 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw std::exception();
     }
   }
-  ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  ReadMetaPage();
 }
 
 void DiskManager::Close() {
+  if (io_uring_ != nullptr) {
+    // 关闭文件前等待所有异步请求完成
+    std::scoped_lock<std::mutex> async_lock(async_latch_);
+    CollectAsync(async_requests_.size());
+  }
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  WritePhysicalPage(META_PAGE_ID, meta_data_);
+  if (!IsReadOnly()) {
+    FlushBitmaps();
+    WritePhysicalPage(META_PAGE_ID, meta_data_);
+    if (compressed_ && !closed) {
+      SaveSlotMap();
+    }
+  }
   if (!closed) {
-    db_io_.close();
+    if (db_map_ != nullptr) {
+      munmap(db_map_, db_map_size_);
+      db_map_ = nullptr;
+    }
+    if (UsesFileDescriptor()) {
+      close(db_fd_);
+    } else {
+      db_io_.close();
+    }
     closed = true;
   }
 }
 //读取逻辑页
 void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
+  auto lock = LockForPageIO();
   ASSERT(logical_page_id >= 0, "Invalid page id.");
+  num_reads_++;
+  if (compressed_) {
+    ReadCompressedPage(logical_page_id, page_data);
+    return;
+  }
+  page_bytes_read_ += PAGE_SIZE;
+  CountDeviceRead(static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE, PAGE_SIZE);
   ReadPhysicalPage(MapPageId(logical_page_id), page_data);
 }
 //将page_data写入到物理页中
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
+  if (IsReadOnly()) {
+    LOG(ERROR) << "Cannot write to a read-only database";
+    return;
+  }
+  auto lock = LockForPageIO();
   ASSERT(logical_page_id >= 0, "Invalid page id.");
+  num_writes_++;
+  if (compressed_) {
+    AlignedPage slot;
+    size_t slot_size = EncodeSlot(logical_page_id, page_data, slot.data_);
+    if (UsesPartialSlotIO()) {
+      PwriteBytes(static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE, slot.data_, RoundToIOBlock(slot_size));
+    } else {
+      WritePhysicalPage(MapPageId(logical_page_id), slot.data_);
+    }
+    return;
+  }
   WritePhysicalPage(MapPageId(logical_page_id), page_data);
 }
-/**
- * TODO: Student Implement
- */
+//按物理页号顺序批量写入，物理上相邻的页合并成一次写
+size_t DiskManager::WritePages(const std::vector<std::pair<page_id_t, const char *>> &pages) {
+  if (IsReadOnly()) {
+    LOG(ERROR) << "Cannot write to a read-only database";
+    return 0;
+  }
+  if (compressed_) {
+    // 压缩后的槽大小不一，物理上相邻的页之间也有空隙，逐页写
+    for (auto &page : pages) {
+      WritePage(page.first, page.second);
+    }
+    return pages.size();
+  }
+  auto lock = LockForPageIO();
+  std::vector<std::pair<page_id_t, const char *>> physical_pages;
+  physical_pages.reserve(pages.size());
+  for (auto &page : pages) {
+    ASSERT(page.first >= 0, "Invalid page id.");
+    physical_pages.emplace_back(MapPageId(page.first), page.second);
+  }
+  std::sort(physical_pages.begin(), physical_pages.end());
+  std::vector<const char *> run;
+  size_t num_writes = 0;
+  for (size_t begin = 0, end; begin < physical_pages.size(); begin = end) {
+    end = begin + 1;
+    while (end < physical_pages.size() && physical_pages[end].first == physical_pages[end - 1].first + 1) {
+      end++;
+    }
+    if (end - begin == 1) {
+      WritePhysicalPage(physical_pages[begin].first, physical_pages[begin].second);
+    } else {
+      run.clear();
+      for (size_t i = begin; i < end; i++) {
+        run.push_back(physical_pages[i].second);
+      }
+      WritePhysicalPages(physical_pages[begin].first, run);
+    }
+    num_writes++;
+  }
+  num_writes_ += pages.size();
+  return num_writes;
+}
+
+void DiskManager::ReadPageAsync(page_id_t logical_page_id, char *page_data, uint64_t tag) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  std::scoped_lock<std::mutex> lock(async_latch_);
+  if (io_uring_ == nullptr || NeedsBounce(page_data)) {
+    ReadPage(logical_page_id, page_data);
+    async_completed_.push_back(tag);
+    return;
+  }
+  num_reads_++;
+  // 压缩的页先读页表提示的扇区数，完成时再解压
+  size_t length = compressed_ ? RoundToIOBlock(GetSlotSizeHint(logical_page_id)) : PAGE_SIZE;
+  PrepareAsync(false, logical_page_id, page_data, length, tag);
+}
+
+void DiskManager::WritePageAsync(page_id_t logical_page_id, const char *page_data, uint64_t tag) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  std::scoped_lock<std::mutex> lock(async_latch_);
+  if (io_uring_ == nullptr || NeedsBounce(page_data) || IsReadOnly()) {
+    WritePage(logical_page_id, page_data);
+    async_completed_.push_back(tag);
+    return;
+  }
+  num_writes_++;
+  PrepareAsync(true, logical_page_id, const_cast<char *>(page_data), PAGE_SIZE, tag);
+}
+
+size_t DiskManager::SubmitAsync() {
+  std::scoped_lock<std::mutex> lock(async_latch_);
+  if (io_uring_ == nullptr) {
+    return 0;
+  }
+  int ret = io_uring_->Submit();
+  if (ret < 0) {
+    LOG(ERROR) << "io_uring submission failed: " << -ret;
+    return 0;
+  }
+  return ret;
+}
+
+size_t DiskManager::ReapAsync(std::vector<uint64_t> &tags, size_t min_complete) {
+  std::scoped_lock<std::mutex> lock(async_latch_);
+  if (io_uring_ != nullptr) {
+    CollectAsync(min_complete);
+  }
+  size_t num_reaped = async_completed_.size();
+  tags.insert(tags.end(), async_completed_.begin(), async_completed_.end());
+  async_completed_.clear();
+  return num_reaped;
+}
+
+size_t DiskManager::GetNumPendingAsync() {
+  std::scoped_lock<std::mutex> lock(async_latch_);
+  return async_requests_.size() - async_free_slots_.size() + async_completed_.size();
+}
+
+void DiskManager::PrepareAsync(bool is_write, page_id_t logical_page_id, char *page_data, size_t length,
+                               uint64_t tag) {
+  if (async_free_slots_.empty()) {
+    // 所有槽位都在使用，至少等一个请求完成
+    CollectAsync(async_completed_.size() + 1);
+  }
+  uint32_t slot = async_free_slots_.back();
+  async_free_slots_.pop_back();
+  if (is_write && compressed_) {
+    // 压缩到槽位自己的缓冲区，写完之前一直有效
+    auto &buffer = async_slots_[slot];
+    if (buffer == nullptr) {
+      buffer = std::make_unique<AlignedPage>();
+    }
+    length = EncodeSlot(logical_page_id, page_data, buffer->data_);
+    length = UsesPartialSlotIO() ? RoundToIOBlock(length) : PAGE_SIZE;
+    page_data = buffer->data_;
+  }
+  async_requests_[slot] = {tag, logical_page_id, page_data, length, is_write};
+  off_t offset = static_cast<off_t>(MapPageId(logical_page_id)) * PAGE_SIZE;
+  // 槽位数等于队列长度，队列不会满
+  bool prepared = is_write ? io_uring_->PrepareWrite(db_fd_, page_data, length, offset, slot)
+                           : io_uring_->PrepareRead(db_fd_, page_data, length, offset, slot);
+  ASSERT(prepared, "io_uring submission queue is full.");
+}
+
+void DiskManager::CollectAsync(size_t min_complete) {
+  while (true) {
+    uint64_t slot;
+    int result;
+    while (io_uring_->PopCompletion(slot, result)) {
+      AsyncRequest &request = async_requests_[slot];
+      page_id_t physical_page_id = MapPageId(request.logical_page_id);
+      if (result != static_cast<int>(request.length)) {
+        // 出错、读到文件末尾或只传输了一部分，同步补做
+        if (result < 0) {
+          LOG(ERROR) << "I/O error in asynchronous " << (request.is_write ? "write" : "read") << ": " << -result;
+        }
+        if (request.is_write) {
+          PwriteBytes(static_cast<size_t>(physical_page_id) * PAGE_SIZE, request.data, request.length);
+        } else if (compressed_) {
+          ReadCompressedPage(request.logical_page_id, request.data);
+        } else {
+          ReadPhysicalPage(physical_page_id, request.data);
+        }
+      } else if (!request.is_write && compressed_) {
+        AlignedPage slot_data;
+        memcpy(slot_data.data_, request.data, request.length);
+        FinishCompressedRead(request.logical_page_id, slot_data.data_, request.length, request.data);
+      } else if (!request.is_write) {
+        page_bytes_read_ += PAGE_SIZE;
+        CountDeviceRead(static_cast<size_t>(physical_page_id) * PAGE_SIZE, PAGE_SIZE);
+      }
+      async_completed_.push_back(request.tag);
+      async_free_slots_.push_back(static_cast<uint32_t>(slot));
+    }
+    bool in_flight = async_free_slots_.size() < async_requests_.size();
+    if (async_completed_.size() >= min_complete || !in_flight) {
+      // 把还没提交的请求交给内核，不等待
+      io_uring_->Submit();
+      return;
+    }
+    int ret = io_uring_->Submit(1);
+    if (ret < 0 && ret != -EBUSY) {
+      LOG(ERROR) << "io_uring submission failed: " << -ret;
+      return;
+    }
+  }
+}
+
 //分配逻辑页
 page_id_t DiskManager::AllocatePage() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (IsReadOnly()) {
+    return INVALID_PAGE_ID;
+  }
   auto page_meta = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
   if(page_meta->GetAllocatedPages() >= MAX_VALID_PAGE_ID)//若已经分配的页数大于最大页数
   {
     return INVALID_PAGE_ID;
   }
-
-  page_id_t page_id = INVALID_PAGE_ID;
-  u_int32_t extent_id = 0;
-  u_int32_t extent_N = page_meta->GetExtentNums();
-  //找到第一个有空余的extent
-  for(; extent_id < extent_N; extent_id++)
-  {
-    if(page_meta->extent_used_page_[extent_id] < BITMAP_SIZE)
-    {
-      break;
-    }
-  }
-  // if(page_id == INVALID_PAGE_ID)
-  // {
-  //   return INVALID_PAGE_ID;
-  // }
-  //找到了空余的extent，计算出物理页号
-  u_int32_t phisical_page_id = extent_id * (BITMAP_SIZE + 1) + 1 ;
-  
-  
-  char page_data[PAGE_SIZE] = {0};
-  ReadPhysicalPage(phisical_page_id, page_data);
-  //处理bitmap
-  BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(page_data);
-  u_int32_t page_offset = 0;
-  bitmap_page->AllocatePage(page_offset);
-  WritePhysicalPage(phisical_page_id, page_data);
+  //从空闲extent的摘要中找到第一个有空余的extent
+  uint32_t extent_id = FindFreeExtent();
+  if (extent_id >= MAX_EXTENTS) {
+    return INVALID_PAGE_ID;
+  }
+  uint32_t page_offset = 0;
+  if (!GetBitmap(extent_id)->AllocatePage(page_offset)) {
+    LOG(ERROR) << "Bitmap of extent " << extent_id << " is inconsistent with the meta page";
+    return INVALID_PAGE_ID;
+  }
+  bitmap_dirty_[extent_id] = true;
   //更新meta_data
   page_meta->num_allocated_pages_++;
   page_meta->extent_used_page_[extent_id]++;
-  page_meta->num_extents_ = extent_id + 1 > extent_N ? extent_id + 1 : extent_N;
-  page_id = extent_id * BITMAP_SIZE + page_offset;
-  return page_id;
+  UseExtent(extent_id);
+  if (page_meta->extent_used_page_[extent_id] >= BITMAP_SIZE) {
+    SetExtentFree(extent_id, false);
+  }
+  return extent_id * BITMAP_SIZE + page_offset;
+}
+
+//分配一段连续的逻辑页，它们在同一个extent中，物理上也连续
+page_id_t DiskManager::AllocatePages(size_t num_pages) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (IsReadOnly() || num_pages == 0 || num_pages > BITMAP_SIZE) {
+    return INVALID_PAGE_ID;
+  }
+  auto page_meta = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  for (uint32_t extent_id = FindFreeExtent(); extent_id < MAX_EXTENTS; extent_id = FindFreeExtent(extent_id + 1)) {
+    //空闲页不够的extent不用读位图
+    if (BITMAP_SIZE - page_meta->GetExtentUsedPage(extent_id) < num_pages) {
+      continue;
+    }
+    uint32_t page_offset = 0;
+    if (!GetBitmap(extent_id)->AllocatePages(num_pages, page_offset)) {
+      continue;
+    }
+    bitmap_dirty_[extent_id] = true;
+    page_meta->num_allocated_pages_ += num_pages;
+    page_meta->extent_used_page_[extent_id] += num_pages;
+    UseExtent(extent_id);
+    if (page_meta->extent_used_page_[extent_id] >= BITMAP_SIZE) {
+      SetExtentFree(extent_id, false);
+    }
+    return extent_id * BITMAP_SIZE + page_offset;
+  }
+  return INVALID_PAGE_ID;
 }
 
-/**
- * TODO: Student Implement
- */
 //释放逻辑页
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (IsReadOnly()) {
+    LOG(ERROR) << "Cannot deallocate a page of a read-only database";
+    return;
+  }
+  if (logical_page_id < 0 || logical_page_id >= MAX_VALID_PAGE_ID) {
+    return;
+  }
   auto page_meta = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
- // if(logical_page_id > INVALID_PAGE_ID)return;
-
-
-  u_int32_t physical_page_id = logical_page_id + 1 + logical_page_id / BITMAP_SIZE - logical_page_id % BITMAP_SIZE;
-  u_int32_t page_offset = logical_page_id % BITMAP_SIZE;
-  u_int32_t extent_id = logical_page_id / BITMAP_SIZE;
-  char page_data[PAGE_SIZE] = {0};
-  ReadPhysicalPage(physical_page_id, page_data);
-
-  BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(page_data);
-  bitmap_page->DeAllocatePage(page_offset);
-  WritePhysicalPage(physical_page_id, page_data);
+  uint32_t page_offset = logical_page_id % BITMAP_SIZE;
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+  if (!GetBitmap(extent_id)->DeAllocatePage(page_offset)) {
+    return;  //本来就是空闲页
+  }
+  bitmap_dirty_[extent_id] = true;
   //更新meta_data
   page_meta->num_allocated_pages_--;
   page_meta->extent_used_page_[extent_id]--;
-
-  return;
+  SetExtentFree(extent_id, true);
 }
 
-/**
- * TODO: Student Implement
- */
 //判断逻辑页是否空闲
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
-  if(logical_page_id > MAX_VALID_PAGE_ID)return false;
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (logical_page_id < 0 || logical_page_id >= MAX_VALID_PAGE_ID) return false;
+  return GetBitmap(logical_page_id / BITMAP_SIZE)->IsPageFree(logical_page_id % BITMAP_SIZE);
+}
+
+void DiskManager::ReadMetaPage() {
+  ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  auto page_meta = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  bitmaps_.resize(MAX_EXTENTS);
+  bitmap_dirty_.assign(MAX_EXTENTS, false);
+  free_extents_.assign((MAX_EXTENTS + 63) / 64, 0);
+  free_extent_words_.assign((free_extents_.size() + 63) / 64, 0);
+  for (uint32_t extent_id = 0; extent_id < MAX_EXTENTS; extent_id++) {
+    // 还没有用到的extent都是空的
+    if (page_meta->GetExtentUsedPage(extent_id) < BITMAP_SIZE) {
+      SetExtentFree(extent_id, true);
+    }
+  }
+  // 文件一旦压缩过就一直按压缩的格式读写
+  if (compressed_ && !IsReadOnly()) {
+    page_meta->SetFlags(page_meta->GetFlags() | DISK_FILE_COMPRESSED);
+  }
+  compressed_ = (page_meta->GetFlags() & DISK_FILE_COMPRESSED) != 0;
+  if (compressed_) {
+    slot_sectors_.resize(MAX_EXTENTS);
+    for (uint32_t extent_id = 0; extent_id < page_meta->GetExtentNums(); extent_id++) {
+      slot_sectors_[extent_id].reset(new std::atomic<uint8_t>[BITMAP_SIZE]());
+    }
+    LoadSlotMap();
+  }
+}
+
+BitmapPage<PAGE_SIZE> *DiskManager::GetBitmap(uint32_t extent_id) {
+  auto &bitmap = bitmaps_[extent_id];
+  if (bitmap == nullptr) {
+    bitmap = std::make_unique<AlignedPage>();
+    ReadPhysicalPage(extent_id * (BITMAP_SIZE + 1) + 1, bitmap->data_);
+  }
+  return reinterpret_cast<BitmapPage<PAGE_SIZE> *>(bitmap->data_);
+}
+
+void DiskManager::SetExtentFree(uint32_t extent_id, bool is_free) {
+  uint64_t &word = free_extents_[extent_id / 64];
+  uint64_t bit = 1ULL << (extent_id % 64);
+  word = is_free ? word | bit : word & ~bit;
+  uint32_t word_id = extent_id / 64;
+  uint64_t word_bit = 1ULL << (word_id % 64);
+  uint64_t &summary = free_extent_words_[word_id / 64];
+  summary = word != 0 ? summary | word_bit : summary & ~word_bit;
+}
+
+uint32_t DiskManager::FindFreeExtent(uint32_t from) const {
+  if (from >= MAX_EXTENTS) {
+    return MAX_EXTENTS;
+  }
+  // from所在的字中可能就有，否则在摘要中找到之后第一个非零的字，再在字中找第一个空闲的extent
+  uint64_t word = free_extents_[from / 64] & (~0ULL << (from % 64));
+  if (word != 0) {
+    return from / 64 * 64 + __builtin_ctzll(word);
+  }
+  size_t word_id = from / 64 + 1;
+  for (size_t i = word_id / 64; i < free_extent_words_.size(); i++) {
+    uint64_t summary = free_extent_words_[i];
+    if (i == word_id / 64) {
+      summary &= ~0ULL << (word_id % 64);
+    }
+    if (summary != 0) {
+      size_t found = i * 64 + __builtin_ctzll(summary);
+      return static_cast<uint32_t>(found * 64 + __builtin_ctzll(free_extents_[found]));
+    }
+  }
+  return MAX_EXTENTS;
+}
+
+void DiskManager::UseExtent(uint32_t extent_id) {
+  auto page_meta = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (extent_id < page_meta->num_extents_) {
+    return;
+  }
+  PreallocateExtents(extent_id + 1);
+  if (compressed_) {
+    for (uint32_t i = page_meta->num_extents_; i <= extent_id; i++) {
+      slot_sectors_[i].reset(new std::atomic<uint8_t>[BITMAP_SIZE]());
+    }
+  }
+  page_meta->num_extents_ = extent_id + 1;
+}
+
+void DiskManager::PreallocateExtents(uint32_t num_extents) {
+  if (!UsesFileDescriptor()) {
+    return;
+  }
+  // 第一个extent从meta页开始，之后的extent从各自的位图页开始
+  auto page_meta = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t first_extent = page_meta->GetExtentNums();
+  off_t begin = first_extent == 0 ? 0 : static_cast<off_t>(first_extent) * (BITMAP_SIZE + 1) + 1;
+  off_t end = static_cast<off_t>(num_extents) * (BITMAP_SIZE + 1) + 1;
+  if (fallocate(db_fd_, 0, begin * PAGE_SIZE, (end - begin) * PAGE_SIZE) != 0 && errno != EOPNOTSUPP) {
+    // 预分配失败时照常在写入时增长文件
+    LOG(WARNING) << "Failed to preallocate extents of " << file_name_ << ": " << errno;
+  }
+}
+
+size_t DiskManager::GetFileAllocatedSize() {
+  struct stat stat_buf;
+  if (stat(file_name_.c_str(), &stat_buf) != 0) {
+    return 0;
+  }
+  return static_cast<size_t>(stat_buf.st_blocks) * 512;
+}
+
+size_t DiskManager::GetFileUsedSize() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto page_meta = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  return (1 + static_cast<size_t>(page_meta->GetExtentNums()) + page_meta->GetAllocatedPages()) * PAGE_SIZE;
+}
+
+void DiskManager::FlushBitmaps() {
+  for (uint32_t extent_id = 0; extent_id < MAX_EXTENTS; extent_id++) {
+    if (bitmap_dirty_[extent_id]) {
+      WritePhysicalPage(extent_id * (BITMAP_SIZE + 1) + 1, bitmaps_[extent_id]->data_);
+      bitmap_dirty_[extent_id] = false;
+    }
+  }
+}
+
+void DiskManager::ReadCompressedPage(page_id_t logical_page_id, char *page_data) {
+  AlignedPage slot;
+  size_t read_size = RoundToIOBlock(GetSlotSizeHint(logical_page_id));
+  if (read_size < PAGE_SIZE) {
+    PreadBytes(static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE, slot.data_, read_size);
+  } else {
+    ReadPhysicalPage(MapPageId(logical_page_id), slot.data_);
+  }
+  FinishCompressedRead(logical_page_id, slot.data_, read_size, page_data);
+}
+
+void DiskManager::FinishCompressedRead(page_id_t logical_page_id, char *slot, size_t read_size, char *page_data) {
+  page_id_t physical_page_id = MapPageId(logical_page_id);
+  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+  size_t slot_size = PAGE_SIZE;
+  bool compressed = IsCompressedSlot(slot, slot_size);
+  if (read_size < slot_size) {
+    // 页表的提示过期了，页后来写成了更大的槽或没有压缩，补读剩下的部分
+    size_t rest = RoundToIOBlock(slot_size) - read_size;
+    PreadBytes(offset + read_size, slot + read_size, rest);
+    read_size += rest;
+  }
+  if (compressed && DecodeSlot(physical_page_id, slot, page_data)) {
+    page_bytes_read_ += read_size;
+    CountDeviceRead(offset, read_size);
+    SetSlotSizeHint(logical_page_id, slot_size);
+    return;
+  }
+  // 没有压缩的页，或者碰巧像压缩槽的页
+  if (read_size < PAGE_SIZE) {
+    PreadBytes(offset + read_size, slot + read_size, PAGE_SIZE - read_size);
+  }
+  memcpy(page_data, slot, PAGE_SIZE);
+  page_bytes_read_ += PAGE_SIZE;
+  CountDeviceRead(offset, PAGE_SIZE);
+  SetSlotSizeHint(logical_page_id, PAGE_SIZE);
+}
+
+void DiskManager::CountDeviceRead(size_t offset, size_t size) {
+  if (direct_io_) {
+    device_bytes_read_ += size;
+    return;
+  }
+  // 经过页缓存的读，内核至少按整页从设备读
+  static const size_t cache_page_size = sysconf(_SC_PAGESIZE);
+  size_t first_page = offset / cache_page_size;
+  size_t end_page = (offset + size + cache_page_size - 1) / cache_page_size;
+  device_bytes_read_ += (end_page - first_page) * cache_page_size;
+}
+
+size_t DiskManager::EncodeSlot(page_id_t logical_page_id, const char *page_data, char *slot) {
+  auto start = std::chrono::steady_clock::now();
+  // 至少省下一个扇区才压缩
+  auto header = reinterpret_cast<SlotHeader *>(slot);
+  size_t capacity = PAGE_SIZE - SECTOR_SIZE - sizeof(SlotHeader);
+  size_t length = PageCodec::Compress(page_data, PAGE_SIZE, slot + sizeof(SlotHeader), capacity);
+  size_t slot_size = PAGE_SIZE;
+  if (length == 0) {
+    memcpy(slot, page_data, PAGE_SIZE);
+    pages_stored_raw_++;
+  } else {
+    header->magic = SLOT_MAGIC;
+    header->checksum = SlotChecksum(MapPageId(logical_page_id), slot + sizeof(SlotHeader), length);
+    header->length = static_cast<uint16_t>(length);
+    header->reserved = 0;
+    slot_size = (sizeof(SlotHeader) + length + SECTOR_SIZE - 1) / SECTOR_SIZE * SECTOR_SIZE;
+    memset(slot + sizeof(SlotHeader) + length, 0, PAGE_SIZE - sizeof(SlotHeader) - length);
+    pages_compressed_++;
+  }
+  std::chrono::duration<uint64_t, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  compress_ns_ += elapsed.count();
+  compress_bytes_in_ += PAGE_SIZE;
+  compress_bytes_out_ += slot_size;
+  SetSlotSizeHint(logical_page_id, slot_size);
+  return slot_size;
+}
+
+bool DiskManager::DecodeSlot(page_id_t physical_page_id, const char *slot, char *page_data) {
+  auto start = std::chrono::steady_clock::now();
+  auto header = reinterpret_cast<const SlotHeader *>(slot);
+  const char *data = slot + sizeof(SlotHeader);
+  if (header->checksum != SlotChecksum(physical_page_id, data, header->length) ||
+      !PageCodec::Decompress(data, header->length, page_data, PAGE_SIZE)) {
+    return false;
+  }
+  std::chrono::duration<uint64_t, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  decompress_ns_ += elapsed.count();
+  pages_decompressed_++;
+  return true;
+}
+
+bool DiskManager::IsCompressedSlot(const char *slot, size_t &slot_size) {
+  auto header = reinterpret_cast<const SlotHeader *>(slot);
+  if (header->magic != SLOT_MAGIC || header->length == 0 || header->length > PAGE_SIZE - sizeof(SlotHeader)) {
+    return false;
+  }
+  slot_size = (sizeof(SlotHeader) + header->length + SECTOR_SIZE - 1) / SECTOR_SIZE * SECTOR_SIZE;
+  return true;
+}
 
-  u_int32_t physical_page_id = logical_page_id + 1 + logical_page_id / BITMAP_SIZE - logical_page_id % BITMAP_SIZE;
-  char page_data[PAGE_SIZE] = {0};
+size_t DiskManager::GetSlotSizeHint(page_id_t logical_page_id) const {
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+  if (!UsesPartialSlotIO() || extent_id >= slot_sectors_.size() || slot_sectors_[extent_id] == nullptr) {
+    return PAGE_SIZE;
+  }
+  uint8_t sectors = slot_sectors_[extent_id][logical_page_id % BITMAP_SIZE].load(std::memory_order_relaxed);
+  return sectors == 0 ? PAGE_SIZE : sectors * SECTOR_SIZE;
+}
 
-  ReadPhysicalPage(physical_page_id, page_data);
+void DiskManager::SetSlotSizeHint(page_id_t logical_page_id, size_t slot_size) {
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+  if (extent_id >= slot_sectors_.size() || slot_sectors_[extent_id] == nullptr) {
+    return;
+  }
+  auto sectors = static_cast<uint8_t>(slot_size / SECTOR_SIZE);
+  slot_sectors_[extent_id][logical_page_id % BITMAP_SIZE].store(sectors, std::memory_order_relaxed);
+}
 
-  BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(page_data);
-  return bitmap_page->IsPageFree(logical_page_id % BITMAP_SIZE);
+void DiskManager::LoadSlotMap() {
+  std::ifstream in(SlotMapFileName(file_name_), std::ios::binary);
+  if (!in.is_open()) {
+    return;
+  }
+  auto page_meta = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  std::vector<char> sectors(BITMAP_SIZE);
+  for (uint32_t extent_id = 0; extent_id < page_meta->GetExtentNums(); extent_id++) {
+    if (!in.read(sectors.data(), BITMAP_SIZE)) {
+      return;  // 不完整的页表，缺的部分按未知处理
+    }
+    for (size_t i = 0; i < BITMAP_SIZE; i++) {
+      slot_sectors_[extent_id][i].store(static_cast<uint8_t>(sectors[i]), std::memory_order_relaxed);
+    }
+  }
+}
+
+void DiskManager::SaveSlotMap() {
+  std::ofstream out(SlotMapFileName(file_name_), std::ios::binary | std::ios::trunc);
+  auto page_meta = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  std::vector<char> sectors(BITMAP_SIZE);
+  for (uint32_t extent_id = 0; extent_id < page_meta->GetExtentNums() && out; extent_id++) {
+    for (size_t i = 0; i < BITMAP_SIZE; i++) {
+      sectors[i] = static_cast<char>(slot_sectors_[extent_id][i].load(std::memory_order_relaxed));
+    }
+    out.write(sectors.data(), BITMAP_SIZE);
+  }
+  if (!out) {
+    LOG(WARNING) << "Failed to save the page map of " << file_name_;
+  }
+}
+
+DiskCompressionStats DiskManager::GetCompressionStats() const {
+  DiskCompressionStats stats;
+  stats.pages_compressed = pages_compressed_;
+  stats.pages_stored_raw = pages_stored_raw_;
+  stats.bytes_in = compress_bytes_in_;
+  stats.bytes_out = compress_bytes_out_;
+  stats.compress_ns = compress_ns_;
+  stats.pages_decompressed = pages_decompressed_;
+  stats.bytes_read = page_bytes_read_;
+  stats.device_bytes_read = device_bytes_read_;
+  stats.decompress_ns = decompress_ns_;
+  return stats;
 }
 
 /**
  * TODO: Student Implement
  */
+//只读映射模式下，返回逻辑页在映射中的地址
+const char *DiskManager::MapPage(page_id_t logical_page_id) {
+  if (db_map_ == nullptr || logical_page_id < 0) {
+    return nullptr;
+  }
+  size_t offset = static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE;
+  if (offset + PAGE_SIZE > db_map_size_) {
+    return nullptr;
+  }
+  size_t slot_size;
+  if (!compressed_ || !IsCompressedSlot(db_map_ + offset, slot_size)) {
+    return db_map_ + offset;
+  }
+  // 压缩的页解压一次，之后一直用解压出的副本
+  std::scoped_lock<std::mutex> lock(map_latch_);
+  auto &page = decoded_pages_[logical_page_id];
+  if (page == nullptr) {
+    page = std::make_unique<AlignedPage>();
+    if (!DecodeSlot(MapPageId(logical_page_id), db_map_ + offset, page->data_)) {
+      memcpy(page->data_, db_map_ + offset, PAGE_SIZE);
+    }
+  }
+  return page->data_;
+}
 //将逻辑页号映射到物理页号
 page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
   return logical_page_id + 1 + logical_page_id / BITMAP_SIZE+1;
 }
+std::unique_lock<std::recursive_mutex> DiskManager::LockForPageIO() {
+  // pread/pwrite不移动文件偏移，不同页的读写可以并发
+  if (UsesFileDescriptor()) {
+    return std::unique_lock<std::recursive_mutex>(db_io_latch_, std::defer_lock);
+  }
+  return std::unique_lock<std::recursive_mutex>(db_io_latch_);
+}
 //获取文件大小
-int DiskManager::GetFileSize(const std::string &file_name) {
+int64_t DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
   return rc == 0 ? stat_buf.st_size : -1;
@@ -149,7 +775,20 @@ int DiskManager::GetFileSize(const std::string &file_name) {
 
 //读取物理页
 void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
+  if (IsReadOnly()) {
+    size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+    if (offset + PAGE_SIZE <= db_map_size_) {
+      memcpy(page_data, db_map_ + offset, PAGE_SIZE);
+    } else {
+      memset(page_data, 0, PAGE_SIZE);
+    }
+    return;
+  }
+  if (UsesFileDescriptor()) {
+    PreadPhysicalPage(physical_page_id, page_data);
+    return;
+  }
+  int64_t offset = static_cast<int64_t>(physical_page_id) * PAGE_SIZE;
   // check if read beyond file length
   if (offset >= GetFileSize(file_name_)) {
 #ifdef ENABLE_BPM_DEBUG
@@ -171,11 +810,19 @@ void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data)
   }
 }
 //写入物理页
-void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
+void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data, size_t num_pages) {
   size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+  if (IsReadOnly()) {
+    LOG(ERROR) << "Cannot write to a read-only database";
+    return;
+  }
+  if (UsesFileDescriptor()) {
+    PwritePhysicalPages(physical_page_id, page_data, num_pages);
+    return;
+  }
   // set write cursor to offset
   db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  db_io_.write(page_data, num_pages * PAGE_SIZE);
   // check for I/O error
   if (db_io_.bad()) {
     LOG(ERROR) << "I/O error while writing";
@@ -183,4 +830,92 @@ void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page
   }
   // needs to flush to keep disk file in sync
   db_io_.flush();
-}
\ No newline at end of file
+}
+//通过文件描述符读取物理页，直接I/O时未对齐的缓冲区经由对齐的中转页
+void DiskManager::PreadPhysicalPage(page_id_t physical_page_id, char *page_data) {
+  if (NeedsBounce(page_data)) {
+    AlignedPage bounce;
+    PreadPhysicalPage(physical_page_id, bounce.data_);
+    memcpy(page_data, bounce.data_, PAGE_SIZE);
+    num_bounced_io_++;
+    return;
+  }
+  PreadBytes(static_cast<size_t>(physical_page_id) * PAGE_SIZE, page_data, PAGE_SIZE);
+}
+
+void DiskManager::PreadBytes(size_t offset, char *data, size_t size) {
+  size_t read_count = 0;
+  while (read_count < size) {
+    ssize_t ret = pread(db_fd_, data + read_count, size - read_count, offset + read_count);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0) {
+      LOG(ERROR) << "I/O error while reading";
+    }
+    if (ret <= 0) break;  // 读到文件末尾，剩下的部分补0
+    read_count += ret;
+  }
+  if (read_count < size) {
+    memset(data + read_count, 0, size - read_count);
+  }
+}
+//通过文件描述符写入连续的物理页，直接I/O时未对齐的缓冲区逐页经由对齐的中转页
+void DiskManager::PwritePhysicalPages(page_id_t physical_page_id, const char *page_data, size_t num_pages) {
+  if (NeedsBounce(page_data)) {
+    AlignedPage bounce;
+    for (size_t i = 0; i < num_pages; i++) {
+      memcpy(bounce.data_, page_data + i * PAGE_SIZE, PAGE_SIZE);
+      PwritePhysicalPages(physical_page_id + i, bounce.data_, 1);
+      num_bounced_io_++;
+    }
+    return;
+  }
+  PwriteBytes(static_cast<size_t>(physical_page_id) * PAGE_SIZE, page_data, num_pages * PAGE_SIZE);
+}
+
+void DiskManager::PwriteBytes(size_t offset, const char *data, size_t size) {
+  size_t write_count = 0;
+  while (write_count < size) {
+    ssize_t ret = pwrite(db_fd_, data + write_count, size - write_count, offset + write_count);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0) {
+      LOG(ERROR) << "I/O error while writing";
+      return;
+    }
+    write_count += ret;
+  }
+}
+//写入物理上连续、内存中分散的多个页
+void DiskManager::WritePhysicalPages(page_id_t physical_page_id, const std::vector<const char *> &pages) {
+  bool aligned = std::none_of(pages.begin(), pages.end(), [this](const char *data) { return NeedsBounce(data); });
+  if (UsesFileDescriptor() && !IsReadOnly() && !aligned) {
+    // 有未对齐的页时无法一次pwritev，逐页写
+    for (size_t i = 0; i < pages.size(); i++) {
+      WritePhysicalPage(physical_page_id + i, pages[i]);
+    }
+    return;
+  }
+  if (UsesFileDescriptor() && !IsReadOnly()) {
+    // 一次pwritev写完整段，不需要先拷贝到连续的缓冲区
+    for (size_t begin = 0; begin < pages.size(); begin += IOV_MAX) {
+      size_t end = std::min(pages.size(), begin + IOV_MAX);
+      std::vector<struct iovec> iov(end - begin);
+      for (size_t i = begin; i < end; i++) {
+        iov[i - begin].iov_base = const_cast<char *>(pages[i]);
+        iov[i - begin].iov_len = PAGE_SIZE;
+      }
+      off_t offset = static_cast<off_t>(physical_page_id + begin) * PAGE_SIZE;
+      ssize_t ret = pwritev(db_fd_, iov.data(), static_cast<int>(iov.size()), offset);
+      if (ret == static_cast<ssize_t>(iov.size() * PAGE_SIZE)) continue;
+      // 被打断或只写了一部分，逐页补写
+      for (size_t i = ret < 0 ? begin : begin + ret / PAGE_SIZE; i < end; i++) {
+        WritePhysicalPage(physical_page_id + i, pages[i]);
+      }
+    }
+    return;
+  }
+  std::vector<char> run(pages.size() * PAGE_SIZE);
+  for (size_t i = 0; i < pages.size(); i++) {
+    memcpy(run.data() + i * PAGE_SIZE, pages[i], PAGE_SIZE);
+  }
+  WritePhysicalPage(physical_page_id, run.data(), pages.size());
+}
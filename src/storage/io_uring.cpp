@@ -0,0 +1,145 @@
+#include "storage/io_uring.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+IoUring::IoUring(unsigned entries) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (fd < 0) {
+    return;
+  }
+  sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+  }
+  sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (sq_ptr_ == MAP_FAILED) {
+    sq_ptr_ = nullptr;
+    close(fd);
+    return;
+  }
+  cq_ptr_ = single_mmap ? sq_ptr_
+                        : mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                               IORING_OFF_CQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (cq_ptr_ == MAP_FAILED || sqes == MAP_FAILED) {
+    if (cq_ptr_ != MAP_FAILED && !single_mmap) munmap(cq_ptr_, cq_size_);
+    if (sqes != MAP_FAILED) munmap(sqes, sqes_size_);
+    munmap(sq_ptr_, sq_size_);
+    sq_ptr_ = cq_ptr_ = nullptr;
+    close(fd);
+    return;
+  }
+  auto *sq = static_cast<char *>(sq_ptr_);
+  sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+  auto *cq = static_cast<char *>(cq_ptr_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  sq_entries_ = params.sq_entries;
+  ring_fd_ = fd;
+}
+
+IoUring::~IoUring() {
+  if (!IsValid()) {
+    return;
+  }
+  munmap(sqes_, sqes_size_);
+  if (cq_ptr_ != sq_ptr_) {
+    munmap(cq_ptr_, cq_size_);
+  }
+  munmap(sq_ptr_, sq_size_);
+  close(ring_fd_);
+}
+
+io_uring_sqe *IoUring::NextSqe() {
+  // 只有本线程写tail，kernel推进head
+  unsigned tail = *sq_tail_;
+  unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (tail - head >= sq_entries_) {
+    return nullptr;
+  }
+  unsigned index = tail & *sq_mask_;
+  io_uring_sqe *sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  return sqe;
+}
+
+bool IoUring::PrepareRead(int fd, char *buf, size_t len, off_t offset, uint64_t user_data) {
+  io_uring_sqe *sqe = NextSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(buf);
+  sqe->len = static_cast<uint32_t>(len);
+  sqe->off = static_cast<uint64_t>(offset);
+  sqe->user_data = user_data;
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+  num_prepared_++;
+  return true;
+}
+
+bool IoUring::PrepareWrite(int fd, const char *buf, size_t len, off_t offset, uint64_t user_data) {
+  io_uring_sqe *sqe = NextSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_WRITE;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(buf);
+  sqe->len = static_cast<uint32_t>(len);
+  sqe->off = static_cast<uint64_t>(offset);
+  sqe->user_data = user_data;
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+  num_prepared_++;
+  return true;
+}
+
+int IoUring::Submit(unsigned wait_for) {
+  if (num_prepared_ == 0 && wait_for == 0) {
+    return 0;
+  }
+  unsigned flags = wait_for > 0 ? IORING_ENTER_GETEVENTS : 0;
+  while (true) {
+    int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, num_prepared_, wait_for, flags, nullptr, 0));
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      return -errno;
+    }
+    num_prepared_ -= static_cast<unsigned>(ret);
+    return ret;
+  }
+}
+
+bool IoUring::PopCompletion(uint64_t &user_data, int &result) {
+  unsigned head = *cq_head_;
+  if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+    return false;
+  }
+  io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+  user_data = cqe->user_data;
+  result = cqe->res;
+  __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
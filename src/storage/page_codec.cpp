@@ -0,0 +1,130 @@
+#include "storage/page_codec.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+static inline uint32_t Load32(const char *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static inline uint32_t Hash(uint32_t value, int bits) { return (value * 2654435761U) >> (32 - bits); }
+
+// 长度不小于15时，token之后用若干字节补足：每个255表示还有后续字节
+static bool WriteLength(char *&op, const char *op_end, size_t length) {
+  while (length >= 255) {
+    if (op >= op_end) return false;
+    *op++ = static_cast<char>(255);
+    length -= 255;
+  }
+  if (op >= op_end) return false;
+  *op++ = static_cast<char>(length);
+  return true;
+}
+
+static bool ReadLength(const char *&ip, const char *ip_end, size_t &length) {
+  uint8_t byte;
+  do {
+    if (ip >= ip_end) return false;
+    byte = static_cast<uint8_t>(*ip++);
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+// 输出一个序列：token、字面量，以及match_length不为0时的偏移和匹配长度
+static bool WriteSequence(char *&op, const char *op_end, const char *literals, size_t num_literals, size_t offset,
+                          size_t match_length, bool last) {
+  if (op >= op_end) return false;
+  char *token = op++;
+  *token = static_cast<char>((std::min<size_t>(num_literals, 15) << 4) | std::min<size_t>(match_length, 15));
+  if (num_literals >= 15 && !WriteLength(op, op_end, num_literals - 15)) return false;
+  if (static_cast<size_t>(op_end - op) < num_literals) return false;
+  memcpy(op, literals, num_literals);
+  op += num_literals;
+  if (last) return true;
+  if (op_end - op < 2) return false;
+  *op++ = static_cast<char>(offset & 0xff);
+  *op++ = static_cast<char>(offset >> 8);
+  return match_length < 15 || WriteLength(op, op_end, match_length - 15);
+}
+
+size_t PageCodec::Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) {
+  if (src_size > MAX_INPUT_SIZE) {
+    return 0;
+  }
+  uint16_t table[1 << HASH_BITS] = {0};
+  const char *ip = src;
+  const char *anchor = src;
+  const char *end = src + src_size;
+  char *op = dst;
+  const char *op_end = dst + dst_capacity;
+  if (src_size >= MIN_MATCH + LAST_LITERALS) {
+    const char *match_end = end - LAST_LITERALS;
+    size_t misses = 0;
+    while (ip + MIN_MATCH <= match_end) {
+      uint32_t sequence = Load32(ip);
+      uint32_t hash = Hash(sequence, HASH_BITS);
+      const char *ref = src + table[hash];
+      table[hash] = static_cast<uint16_t>(ip - src);
+      if (ref >= ip || Load32(ref) != sequence) {
+        // 连续找不到匹配时加大步长，不可压缩的数据很快扫完
+        ip += 1 + (misses++ >> 6);
+        continue;
+      }
+      misses = 0;
+      const char *match = ip + MIN_MATCH;
+      ref += MIN_MATCH;
+      while (match < match_end && *match == *ref) {
+        match++;
+        ref++;
+      }
+      if (!WriteSequence(op, op_end, anchor, ip - anchor, match - ref, match - ip - MIN_MATCH, false)) {
+        return 0;
+      }
+      table[Hash(Load32(match - 2), HASH_BITS)] = static_cast<uint16_t>(match - 2 - src);
+      ip = anchor = match;
+    }
+  }
+  if (!WriteSequence(op, op_end, anchor, end - anchor, 0, 0, true)) {
+    return 0;
+  }
+  return op - dst;
+}
+
+bool PageCodec::Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) {
+  const char *ip = src;
+  const char *ip_end = src + src_size;
+  char *op = dst;
+  char *op_end = dst + dst_size;
+  while (ip < ip_end) {
+    auto token = static_cast<uint8_t>(*ip++);
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !ReadLength(ip, ip_end, num_literals)) return false;
+    if (static_cast<size_t>(ip_end - ip) < num_literals || static_cast<size_t>(op_end - op) < num_literals) {
+      return false;
+    }
+    memcpy(op, ip, num_literals);
+    op += num_literals;
+    ip += num_literals;
+    if (ip == ip_end) break;  // 最后一个序列只有字面量
+    if (ip_end - ip < 2) return false;
+    size_t offset = static_cast<uint8_t>(ip[0]) | static_cast<size_t>(static_cast<uint8_t>(ip[1])) << 8;
+    ip += 2;
+    size_t match_length = token & 15;
+    if (match_length == 15 && !ReadLength(ip, ip_end, match_length)) return false;
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > static_cast<size_t>(op - dst) || static_cast<size_t>(op_end - op) < match_length) {
+      return false;
+    }
+    // 匹配可能与输出重叠，逐字节复制
+    const char *ref = op - offset;
+    for (size_t i = 0; i < match_length; i++) {
+      op[i] = ref[i];
+    }
+    op += match_length;
+  }
+  return op == op_end;
+}
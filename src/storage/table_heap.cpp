@@ -10,6 +10,7 @@ bool TableHeap::InsertTuple(Row &row, Txn *txn) {
   // Step4: If the tuple is successfully inserted, return true.
   uint32_t size = row.GetSerializedSize(schema_);
   if (size >= PAGE_SIZE) return false;
+  if (buffer_pool_manager_->IsReadOnly()) return false;//只读映射的页不能写
 
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));//找到第一个page
   if(page == nullptr) return false;//如果page为空，返回false
@@ -17,38 +18,61 @@ bool TableHeap::InsertTuple(Row &row, Txn *txn) {
   int result = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);//插入tuple
   page->WUnlatch();//释放写锁
   buffer_pool_manager_->UnpinPage(first_page_id_, true);//解锁
+  bool grown = false;//是否已经为这个元组扩展过
   while(!result){//如果插入失败
     page_id_t next_id = page->GetNextPageId();//获取下一个page的id
-    if(next_id != INVALID_PAGE_ID){//如果有下一个page
-      page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_id));//获取下一个page
-      if(page == nullptr) return false;//如果page为空，返回false
-      page->WLatch();//获取写锁
-      result = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);//插入tuple
-      page->WUnlatch();//释放写锁
-      buffer_pool_manager_->UnpinPage(next_id, true);//解锁
-    }else{//如果没有下一个page
-    //创建新的page
-      page_id_t new_pid;
-      buffer_pool_manager_->NewPage(new_pid);//在buffer_pool_manager中创建新的page
-      auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(new_pid));//获取新的page
-      new_page->WLatch();//获取写锁
-      new_page->Init(new_pid, INVALID_PAGE_ID, log_manager_, txn);//初始化新的page
-      new_page->SetNextPageId(INVALID_PAGE_ID);//设置下一个page的id
-      page->WLatch();//获取写锁
-      page->SetNextPageId(new_pid);//设置下一个page的id
-      page->WUnlatch();//释放写锁
-      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);//解锁
-      result = new_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);//插入tuple
-      new_page->WUnlatch();//释放写锁
-      buffer_pool_manager_->UnpinPage(new_page->GetPageId(), true);//解锁
-      break;
+    if(next_id == INVALID_PAGE_ID){//如果没有下一个page
+      if(grown) return false;//新的空页也放不下
+      //一次在末尾追加一组页，页号和磁盘上的位置都连续
+      next_id = GrowHeap(page->GetTablePageId(), txn);
+      if(next_id == INVALID_PAGE_ID) return false;//缓冲池或磁盘已满
+      grown = true;
     }
+    page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_id));//获取下一个page
+    if(page == nullptr) return false;//如果page为空，返回false
+    page->WLatch();//获取写锁
+    result = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);//插入tuple
+    page->WUnlatch();//释放写锁
+    buffer_pool_manager_->UnpinPage(next_id, true);//解锁
   }
   if(result) return true;//如果插入成功，返回true
   return false;
 }
 
+page_id_t TableHeap::GrowHeap(page_id_t last_page_id, Txn *txn) {
+  auto last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
+  if (last_page == nullptr) return INVALID_PAGE_ID;
+  std::vector<Page *> pages = buffer_pool_manager_->NewPages(TABLE_HEAP_GROWTH_PAGES);
+  if (pages.empty()) {
+    // 空闲的frame不够一组，只追加一页
+    page_id_t page_id;
+    Page *page = buffer_pool_manager_->NewPage(page_id);
+    if (page == nullptr) {
+      buffer_pool_manager_->UnpinPage(last_page_id, false);
+      return INVALID_PAGE_ID;
+    }
+    pages.push_back(page);
+  }
+  for (size_t i = 0; i < pages.size(); i++) {
+    auto table_page = reinterpret_cast<TablePage *>(pages[i]);
+    page_id_t prev_page_id = i == 0 ? last_page_id : pages[i - 1]->GetPageId();
+    page_id_t next_page_id = i + 1 < pages.size() ? pages[i + 1]->GetPageId() : INVALID_PAGE_ID;
+    table_page->WLatch();
+    table_page->Init(pages[i]->GetPageId(), prev_page_id, log_manager_, txn);
+    table_page->SetNextPageId(next_page_id);
+    table_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(pages[i]->GetPageId(), true);
+  }
+  page_id_t first_page_id = pages[0]->GetPageId();
+  last_page->WLatch();
+  last_page->SetNextPageId(first_page_id);
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  return first_page_id;
+}
+
 bool TableHeap::MarkDelete(const RowId &rid, Txn *txn) {
+  if (buffer_pool_manager_->IsReadOnly()) return false;
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   // If the page could not be found, then abort the recovery.
@@ -67,6 +91,7 @@ bool TableHeap::MarkDelete(const RowId &rid, Txn *txn) {
  * TODO: Student Implement
  */
 bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Txn *txn) { 
+  if (buffer_pool_manager_->IsReadOnly()) return false;
   auto page_old = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));//获取page
   page_old->WLatch();//获取写锁
   Row old_row = Row(rid);//创建一个空的row
@@ -86,6 +111,7 @@ void TableHeap::ApplyDelete(const RowId &rid, Txn *txn) {
   // Step1: Find the page which contains the tuple.
   // Step2: Delete the tuple from the page.
   // Step3: If the tuple is successfully deleted, return true.
+  if (buffer_pool_manager_->IsReadOnly()) return;
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));//获取page
   page->WLatch();//获取写锁
   page->ApplyDelete(rid, txn, log_manager_);//调用page的ApplyDelete删除tuple
@@ -95,6 +121,7 @@ void TableHeap::ApplyDelete(const RowId &rid, Txn *txn) {
 }
 
 void TableHeap::RollbackDelete(const RowId &rid, Txn *txn) {
+  if (buffer_pool_manager_->IsReadOnly()) return;
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   assert(page != nullptr);
@@ -134,14 +161,17 @@ void TableHeap::DeleteTable(page_id_t page_id) {
 /**
  * TODO: Student Implement
  */
-TableIterator TableHeap::Begin(Txn *txn) { 
+TableIterator TableHeap::Begin(Txn *txn, bool bulk_read) { 
   //获取堆表的首迭代器；
-  auto page_tmp = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));//获取page
+  std::shared_ptr<BufferRing> ring;
+  if (bulk_read) ring = buffer_pool_manager_->NewBufferRing();//顺序扫描使用私有的buffer ring
+  auto page_tmp = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_, ring.get()));//获取page
   page_tmp->RLatch();//获取读锁
   RowId rid;
   page_tmp->GetFirstTupleRid(&rid);//获取第一个tuple的RowId
   page_tmp->RUnlatch();//释放读锁
-  return TableIterator(this, rid, txn);
+  buffer_pool_manager_->UnpinPage(first_page_id_, false);
+  return TableIterator(this, rid, txn, ring);
  }
 
 /**
@@ -1,19 +1,25 @@
 #include "storage/table_iterator.h"
 
+#include <algorithm>
+
 #include "common/macros.h"
 #include "storage/table_heap.h"
 
 /**
  * TODO: Student Implement
  */
-TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Txn *txn) {
+TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Txn *txn, std::shared_ptr<BufferRing> ring) {
   tableHeap_ = table_heap;
   currentRowID_ = rid;
+  ring_ = std::move(ring);
 }
 
 TableIterator::TableIterator(const TableIterator &other) {
   tableHeap_ = other.tableHeap_;
   currentRowID_ = other.currentRowID_;
+  ring_ = other.ring_;
+  read_ahead_page_ = other.read_ahead_page_;
+  read_ahead_ = other.read_ahead_;
 }
 
 TableIterator::~TableIterator() {
@@ -47,14 +53,18 @@ Row *TableIterator::operator->() {
 TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
   tableHeap_ = itr.tableHeap_;
   currentRowID_ = itr.currentRowID_;
+  ring_ = itr.ring_;
+  read_ahead_page_ = itr.read_ahead_page_;
+  read_ahead_ = itr.read_ahead_;
   return *this;
 }
 
 TableIterator &TableIterator::operator++() {  // 前置++
   BufferPoolManager *buffer_pool_manager_ = tableHeap_->buffer_pool_manager_;
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(currentRowID_.GetPageId()));
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(currentRowID_.GetPageId(), ring_.get()));
   page->RLatch();
   ASSERT(page != nullptr, "page is null");
+  ReadAhead(page);
   RowId new_rid;
   if(!page->GetNextTupleRid(currentRowID_,&new_rid))
   {
@@ -62,8 +72,9 @@ TableIterator &TableIterator::operator++() {  // 前置++
     {
       page->RUnlatch();
       buffer_pool_manager_->UnpinPage(page->GetPageId(),false);
-      page=reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page->GetNextPageId()));
+      page=reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page->GetNextPageId(), ring_.get()));
       page->RLatch();
+      ReadAhead(page);
       if(page->GetFirstTupleRid(&new_rid))
         break;
     }
@@ -72,12 +83,68 @@ TableIterator &TableIterator::operator++() {  // 前置++
   if(tableHeap_->End()!=*this)
     tableHeap_->End().currentRowID_=new_rid;
   page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(currentRowID_.GetPageId(),false);
+  buffer_pool_manager_->UnpinPage(page->GetPageId(),false);//到达末尾时new_rid无效，按page解除pin
   return *this;
 }
 TableIterator TableIterator::operator++(int) {
   TableHeap* tableHeap = tableHeap_;
   RowId currentRowID = currentRowID_;
   ++(*this);
-  return TableIterator(tableHeap, currentRowID, nullptr);
+  return TableIterator(tableHeap, currentRowID, nullptr, ring_);
+}
+
+void TableIterator::ReadAhead(TablePage *page) {
+  BufferPoolManager *buffer_pool_manager_ = tableHeap_->buffer_pool_manager_;
+  if (!buffer_pool_manager_->IsPrefetching()) {
+    return;
+  }
+  page_id_t page_id = page->GetTablePageId();
+  // 只在游标进入新的page时预读，同一page上的元组不再查找链表
+  if (page_id == read_ahead_page_) {
+    return;
+  }
+  read_ahead_page_ = page_id;
+  // forget the pages up to the cursor, everything if the cursor left the chain we were reading
+  while (!read_ahead_.empty() && read_ahead_.front() != page_id) {
+    read_ahead_.pop_front();
+  }
+  if (!read_ahead_.empty()) {
+    read_ahead_.pop_front();
+  }
+  // a scan through a ring keeps at most half of its frames in flight, the others hold the pages it is reading, so
+  // that pages read ahead are not recycled before the cursor gets to them
+  size_t depth = DEFAULT_READ_AHEAD_PAGES;
+  if (ring_ != nullptr) {
+    depth = std::min(depth, ring_->GetRingSize() / 2);
+  }
+  // the chain goes on from the last page asked for, once it has been read
+  if (read_ahead_.size() >= depth ||
+      (!read_ahead_.empty() && !buffer_pool_manager_->IsPageReady(read_ahead_.back()))) {
+    return;
+  }
+  std::vector<page_id_t> page_ids;
+  page_id_t next_page_id = read_ahead_.empty() ? page->GetNextPageId() : NextResidentPageId(read_ahead_.back());
+  while (next_page_id != INVALID_PAGE_ID) {
+    page_ids.push_back(next_page_id);
+    read_ahead_.push_back(next_page_id);
+    // 队列满了就不再查找下一页，否则每次换页都白白pin一次
+    if (read_ahead_.size() >= depth) {
+      break;
+    }
+    next_page_id = NextResidentPageId(next_page_id);
+  }
+  buffer_pool_manager_->PrefetchPages(page_ids, ring_.get());
+}
+
+page_id_t TableIterator::NextResidentPageId(page_id_t page_id) {
+  BufferPoolManager *buffer_pool_manager_ = tableHeap_->buffer_pool_manager_;
+  Page *page = buffer_pool_manager_->TryFetchPage(page_id);
+  if (page == nullptr) {
+    return INVALID_PAGE_ID;
+  }
+  page->RLatch();
+  page_id_t next_page_id = reinterpret_cast<TablePage *>(page)->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return next_page_id;
 }
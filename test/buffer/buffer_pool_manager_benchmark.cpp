@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+/**
+ * Every thread fetches and unpins random resident pages, so the numbers show how well the pool's latching scales
+ * with the number of threads rather than how fast the disk is. The benchmark runs once with the pages unpinned in
+ * between, and once with every page held pinned by the main thread, like the root and upper levels of a busy index,
+ * which are pinned without the latch.
+ */
+static double FetchUnpinThroughput(BufferPoolManager *bpm, int num_pages, size_t num_threads, int ops_per_thread) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([=] {
+      std::mt19937 rng(t);
+      std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+      for (int i = 0; i < ops_per_thread; i++) {
+        page_id_t page_id = dist(rng);
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        bpm->UnpinPage(page_id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return num_threads * ops_per_thread / elapsed.count();
+}
+
+TEST(BufferPoolManagerBenchmark, FetchUnpinThroughput) {
+  const int num_pages = 4096;
+  const int ops_per_thread = 200000;
+  const size_t num_instances = 16;
+
+  const std::string db_names[] = {"bpm_benchmark_0.db", "bpm_benchmark_1.db"};
+  DiskManager *disk_managers[2];
+  for (int i = 0; i < 2; i++) {
+    remove(db_names[i].c_str());
+    disk_managers[i] = new DiskManager(db_names[i]);
+  }
+  std::vector<std::pair<std::string, BufferPoolManager *>> pools = {
+      {"single", new BufferPoolManager(num_pages, disk_managers[0])},
+      {"parallel x" + std::to_string(num_instances),
+       new ParallelBufferPoolManager(num_instances, num_pages + num_instances, disk_managers[1])}};
+  for (auto &pool : pools) {
+    for (int i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, pool.second->NewPage(page_id));
+      pool.second->UnpinPage(page_id, false);
+    }
+  }
+
+  printf("%-14s %8s %14s %14s\n", "pool", "threads", "ops/s", "pinned ops/s");
+  size_t max_threads = std::max(4U, std::thread::hardware_concurrency());
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    for (auto &pool : pools) {
+      double ops = FetchUnpinThroughput(pool.second, num_pages, threads, ops_per_thread);
+      for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+        ASSERT_NE(nullptr, pool.second->FetchPage(page_id));
+      }
+      double pinned_ops = FetchUnpinThroughput(pool.second, num_pages, threads, ops_per_thread);
+      for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+        pool.second->UnpinPage(page_id, false);
+      }
+      printf("%-14s %8zu %14.0f %14.0f\n", pool.first.c_str(), threads, ops, pinned_ops);
+    }
+  }
+
+  for (auto &pool : pools) {
+    delete pool.second;
+  }
+  for (int i = 0; i < 2; i++) {
+    disk_managers[i]->Close();
+    delete disk_managers[i];
+    remove(db_names[i].c_str());
+  }
+}
+
+/**
+ * The random read/modify workload of BufferPoolManagerTest.BackgroundWriterTest on a pool a quarter of the table,
+ * with and without the background writer, showing how many victims the foreground still has to write itself and in
+ * how many writes the background writer flushes its pages.
+ */
+TEST(BufferPoolManagerBenchmark, BackgroundWriter) {
+  const std::string db_name = "bpm_benchmark.db";
+  const size_t buffer_pool_size = 64;
+  const int num_pages = 256;
+  const int num_ops = 200000;
+
+  printf("%-12s %10s %14s %8s %12s %10s %12s\n", "writer", "evictions", "victim writes", "waits", "bg pages",
+         "bg writes", "ops/s");
+  for (bool background : {false, true}) {
+    remove(db_name.c_str());
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+    if (background) {
+      bpm->StartBackgroundWriter(0.5);
+    }
+    for (int i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, bpm->NewPage(page_id));
+      bpm->UnpinPage(page_id, true);
+    }
+    std::mt19937 rng(15445);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_ops; i++) {
+      page_id_t page_id = rng() % num_pages;
+      Page *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      bool modify = rng() % 2 == 0;
+      if (modify) {
+        page->GetData()[0]++;
+      }
+      bpm->UnpinPage(page_id, modify);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    BufferWriterStats stats = bpm->GetWriterStats();
+    printf("%-12s %10lu %14lu %8lu %12lu %10lu %12.0f\n", background ? "background" : "foreground", stats.evictions,
+           stats.fg_victim_writes, stats.fg_write_waits, stats.bg_pages_written, stats.bg_writes,
+           num_ops / elapsed.count());
+    delete bpm;
+    disk_manager->Close();
+    delete disk_manager;
+  }
+  remove(db_name.c_str());
+}
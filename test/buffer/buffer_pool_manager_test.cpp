@@ -1,8 +1,13 @@
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 
+#include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -71,4 +76,464 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+TEST(BufferPoolManagerTest, BackgroundWriterTest) {
+  const std::string db_name = "bpm_test.db";
+  const size_t buffer_pool_size = 64;
+  const int num_pages = 256;
+  const int num_ops = 20000;
+
+  // Run the same random read/modify workload with and without the background writer, then reopen the file and check
+  // that every page holds its last version.
+  for (bool background : {false, true}) {
+    remove(db_name.c_str());
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+    if (background) {
+      bpm->StartBackgroundWriter(0.5);
+    }
+    std::vector<uint32_t> versions(num_pages, 0);
+    for (int i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, bpm->NewPage(page_id));
+      ASSERT_EQ(i, page_id);
+      bpm->UnpinPage(page_id, true);
+    }
+    std::mt19937 rng(15445);
+    for (int i = 0; i < num_ops; i++) {
+      page_id_t page_id = rng() % num_pages;
+      Page *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      uint32_t version;
+      memcpy(&version, page->GetData(), sizeof(version));
+      ASSERT_EQ(versions[page_id], version);
+      bool modify = rng() % 2 == 0;
+      if (modify) {
+        version = ++versions[page_id];
+        memcpy(page->GetData(), &version, sizeof(version));
+      }
+      bpm->UnpinPage(page_id, modify);
+    }
+    // the pool is still half dirty, give the background writer a chance to run on short workloads
+    for (int i = 0; background && i < 100 && bpm->GetWriterStats().bg_pages_written == 0; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(BG_WRITER_INTERVAL_MS));
+    }
+    BufferWriterStats stats = bpm->GetWriterStats();
+    if (background) {
+      EXPECT_GT(stats.bg_pages_written, 0);
+      EXPECT_LE(stats.bg_writes, stats.bg_pages_written);
+    } else {
+      EXPECT_EQ(0, stats.bg_pages_written);
+    }
+    delete bpm;
+    disk_manager->Close();
+    delete disk_manager;
+
+    disk_manager = new DiskManager(db_name);
+    char buf[PAGE_SIZE];
+    for (int i = 0; i < num_pages; i++) {
+      disk_manager->ReadPage(i, buf);
+      uint32_t version;
+      memcpy(&version, buf, sizeof(version));
+      EXPECT_EQ(versions[i], version);
+    }
+    disk_manager->Close();
+    delete disk_manager;
+  }
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, PinnedPageTest) {
+  const std::string db_name = "bpm_test.db";
+  const size_t buffer_pool_size = 16;
+  const int num_hot_pages = 4;
+  const int num_pages = 64;
+  const size_t num_threads = 4;
+  const int num_ops = 20000;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    memcpy(page->GetData(), &page_id, sizeof(page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+  std::vector<Page *> hot_pages;
+  for (page_id_t page_id = 0; page_id < num_hot_pages; page_id++) {
+    hot_pages.push_back(bpm->FetchPage(page_id));
+    ASSERT_NE(nullptr, hot_pages.back());
+  }
+
+  // Scenario: while the hot pages stay pinned, threads pin them again (without the latch) mixed with cold pages which
+  // keep evicting each other, and every pin returns the frame of the requested page.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([=] {
+      std::mt19937 rng(t);
+      for (int i = 0; i < num_ops; i++) {
+        page_id_t page_id = i % 2 == 0 ? rng() % num_hot_pages : num_hot_pages + rng() % (num_pages - num_hot_pages);
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        page_id_t content;
+        memcpy(&content, page->GetData(), sizeof(content));
+        ASSERT_EQ(page_id, page->GetPageId());
+        ASSERT_EQ(page_id, content);
+        bpm->UnpinPage(page_id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (page_id_t page_id = 0; page_id < num_hot_pages; page_id++) {
+    EXPECT_EQ(1, hot_pages[page_id]->GetPinCount());
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: once unpinned, the hot pages can be evicted like any other page.
+  for (page_id_t page_id = num_hot_pages; page_id < num_pages; page_id++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, ReadOnlyMmapTest) {
+  const std::string db_name = "bpm_test.db";
+  const size_t buffer_pool_size = 10;
+  const int num_pages = 200;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+
+  disk_manager = new DiskManager(db_name, DiskIOBackend::kMmap);
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  EXPECT_EQ(0, bpm->GetPoolSize());
+
+  // Scenario: far more pages than the pool size can be pinned at once, each one used in place from the mapping.
+  char expected[PAGE_SIZE];
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(disk_manager->MapPage(i), page->GetData());
+    snprintf(expected, PAGE_SIZE, "page %d", i);
+    EXPECT_STREQ(expected, page->GetData());
+  }
+  EXPECT_EQ(0, disk_manager->GetNumReads());
+  EXPECT_FALSE(bpm->CheckAllUnpinned());
+
+  // Scenario: nothing can be allocated, deleted or fetched beyond the file.
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id));
+  EXPECT_FALSE(bpm->DeletePage(0));
+  EXPECT_EQ(nullptr, bpm->FetchPage(num_pages + DiskManager::BITMAP_SIZE));
+
+  // Scenario: a dirty unpin is refused but still drops the pin, and nothing is written to the mapped file.
+  EXPECT_TRUE(bpm->IsReadOnly());
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_FALSE(bpm->UnpinPage(0, true));
+  memset(expected, 0, PAGE_SIZE);
+  disk_manager->WritePage(1, expected);
+  EXPECT_EQ(0, disk_manager->WritePages({{2, expected}}));
+  EXPECT_EQ(0, disk_manager->GetNumWrites());
+  EXPECT_STREQ("page 1", bpm->FetchPage(1)->GetData());
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+
+  for (int i = 0; i < num_pages; i++) {
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  EXPECT_FALSE(bpm->UnpinPage(0, false));
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, BufferStatsTest) {
+  const std::string db_name = "bpm_test.db";
+  const size_t buffer_pool_size = 3;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  auto kind_stats = [bpm](PageKind kind) { return bpm->GetBufferStats().kinds[static_cast<size_t>(kind)]; };
+
+  // pages 0 and 1 are the catalog pages, 2 and 3 look like table pages, 4 like a B+ tree leaf and 5 like an internal
+  for (page_id_t i = 0; i < 6; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(i, page_id);
+    char *data = page->GetData();
+    if (i == 2 || i == 3) {
+      memcpy(data, &i, sizeof(i));
+    } else if (i >= 4) {
+      int32_t page_type = i == 4 ? 1 : 2;
+      memcpy(data, &page_type, sizeof(page_type));
+      memcpy(data + 24, &i, sizeof(i));
+    }
+    bpm->UnpinPage(page_id, true);
+  }
+  char data[PAGE_SIZE] = {0};
+  EXPECT_EQ(PageKind::kOther, BufferPoolManager::ClassifyPage(6, data));
+  uint32_t metadata_magic_num = 344528;
+  memcpy(data, &metadata_magic_num, sizeof(metadata_magic_num));
+  EXPECT_EQ(PageKind::kCatalog, BufferPoolManager::ClassifyPage(6, data));
+
+  // Scenario: the first three pages were evicted dirty to make room for the others.
+  BufferKindStats total = bpm->GetBufferStats().Total();
+  EXPECT_EQ(3, total.evictions);
+  EXPECT_EQ(3, total.dirty_writebacks);
+  EXPECT_EQ(2, kind_stats(PageKind::kCatalog).evictions);
+  EXPECT_EQ(1, kind_stats(PageKind::kTable).evictions);
+
+  // Scenario: a resident page is a hit of its kind, an evicted one a miss which evicts the least recent page.
+  ASSERT_NE(nullptr, bpm->FetchPage(5));
+  EXPECT_EQ(1, kind_stats(PageKind::kIndexInternal).hits);
+  ASSERT_NE(nullptr, bpm->FetchPage(2));
+  EXPECT_EQ(1, kind_stats(PageKind::kTable).misses);
+  EXPECT_EQ(2, kind_stats(PageKind::kTable).evictions);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(page_id));
+  EXPECT_EQ(1, kind_stats(PageKind::kIndexLeaf).evictions);
+
+  // Scenario: with every frame pinned, fetches and allocations fail and are counted.
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id));
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+  BufferPoolStats stats = bpm->GetBufferStats();
+  EXPECT_EQ(2, stats.failed_victim_searches);
+  EXPECT_EQ(1, stats.Total().hits);
+  EXPECT_EQ(1, stats.Total().misses);
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, ResizeTest) {
+  const std::string db_name = "bpm_test.db";
+  const size_t buffer_pool_size = 4;
+  const size_t max_pool_size = 8;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, ReplacerType::kLRU, max_pool_size);
+  EXPECT_EQ(max_pool_size, bpm->GetMaxPoolSize());
+  EXPECT_FALSE(bpm->Resize(0));
+  EXPECT_FALSE(bpm->Resize(max_pool_size + 1));
+
+  // the pages fill frames 0 to 3 in order, page 3 stays pinned in the last frame
+  Page *pinned = nullptr;
+  for (page_id_t i = 0; i < 4; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    if (i == 3) {
+      pinned = page;
+    } else {
+      bpm->UnpinPage(page_id, true);
+    }
+  }
+
+  // Scenario: shrinking writes the unpinned page of a removed frame back, the pinned one stays valid.
+  ASSERT_TRUE(bpm->Resize(2));
+  EXPECT_EQ(2, bpm->GetPoolSize());
+  EXPECT_EQ(1, bpm->GetBufferStats().Total().evictions);
+  EXPECT_EQ(1, bpm->GetBufferStats().Total().dirty_writebacks);
+  EXPECT_EQ(0, strcmp(pinned->GetData(), "page 3"));
+  ASSERT_EQ(pinned, bpm->FetchPage(3));
+  snprintf(pinned->GetData(), PAGE_SIZE, "page 3 updated");
+  EXPECT_TRUE(bpm->UnpinPage(3, true));
+  EXPECT_EQ(1, bpm->GetBufferStats().Total().evictions);
+  // its last unpin takes the frame out of the pool
+  EXPECT_TRUE(bpm->UnpinPage(3, false));
+  EXPECT_EQ(2, bpm->GetBufferStats().Total().evictions);
+  EXPECT_EQ(2, bpm->GetBufferStats().Total().dirty_writebacks);
+
+  // Scenario: only two pages can be pinned at once now, and the retired pages are read back from disk.
+  Page *page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  Page *page3 = bpm->FetchPage(3);
+  ASSERT_NE(nullptr, page3);
+  EXPECT_EQ(0, strcmp(page3->GetData(), "page 3 updated"));
+  EXPECT_EQ(nullptr, bpm->FetchPage(2));
+  bpm->UnpinPage(3, false);
+  Page *page2 = bpm->FetchPage(2);
+  ASSERT_NE(nullptr, page2);
+  EXPECT_EQ(0, strcmp(page2->GetData(), "page 2"));
+  bpm->UnpinPage(2, false);
+
+  // Scenario: growing back to the capacity lets every frame be pinned.
+  ASSERT_TRUE(bpm->Resize(max_pool_size));
+  EXPECT_EQ(max_pool_size, bpm->GetPoolSize());
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 1; i < max_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    page_ids.push_back(page_id);
+  }
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id));
+  bpm->UnpinPage(0, false);
+  for (auto id : page_ids) {
+    bpm->UnpinPage(id, false);
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, WarmRestartTest) {
+  const std::string db_name = "bpm_test.db";
+  const std::string warm_file_name = "bpm_test.db.warm";
+  const size_t buffer_pool_size = 8;
+
+  remove(db_name.c_str());
+  remove(warm_file_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  for (size_t i = 0; i < 2 * buffer_pool_size; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    memcpy(page->GetData(), &page_id, sizeof(page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+
+  // Scenario: the resident pages are listed from the most recently pinned one.
+  for (page_id_t page_id : {12, 9, 14}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+  auto resident = bpm->GetResidentPages();
+  ASSERT_EQ(buffer_pool_size, resident.size());
+  EXPECT_EQ(14, resident[0]);
+  EXPECT_EQ(9, resident[1]);
+  EXPECT_EQ(12, resident[2]);
+  ASSERT_TRUE(bpm->SaveResidentPages(warm_file_name));
+  delete bpm;
+
+  // Scenario: a smaller pool only reloads the most recent pages, and fetching them afterwards does no I/O.
+  bpm = new BufferPoolManager(3, disk_manager);
+  EXPECT_EQ(0, bpm->WarmUp(warm_file_name));
+  bpm->StartPrefetcher(2);
+  EXPECT_EQ(3, bpm->WarmUp(warm_file_name));
+  std::vector<page_id_t> warm = {9, 12, 14};
+  for (int i = 0; i < 1000 && !(bpm->IsPageReady(9) && bpm->IsPageReady(12) && bpm->IsPageReady(14)); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  uint64_t reads = disk_manager->GetNumReads();
+  for (auto page_id : warm) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, memcmp(page->GetData(), &page_id, sizeof(page_id)));
+    bpm->UnpinPage(page_id, false);
+  }
+  EXPECT_EQ(reads, disk_manager->GetNumReads());
+
+  // Scenario: a missing list warms nothing up.
+  EXPECT_EQ(0, bpm->WarmUp("missing.warm"));
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+  remove(warm_file_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, AccessTraceTest) {
+  const std::string db_name = "bpm_test.db";
+  const std::string trace_name = "bpm_test.trace";
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(4, disk_manager);
+  PageAccessTrace trace;
+  bpm->SetAccessTrace(&trace);
+
+  // Scenario: fetches are recorded in order, allocations are not.
+  page_id_t page_id;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+  for (page_id_t id : {2, 0, 2}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(id));
+    bpm->UnpinPage(id, false);
+  }
+  bpm->SetAccessTrace(nullptr);
+  ASSERT_NE(nullptr, bpm->FetchPage(1));
+  bpm->UnpinPage(1, false);
+  EXPECT_EQ(std::vector<page_id_t>({2, 0, 2}), trace.GetPageIds());
+
+  // Scenario: a saved trace is loaded back unchanged.
+  ASSERT_TRUE(trace.Save(trace_name));
+  std::vector<page_id_t> loaded;
+  ASSERT_TRUE(PageAccessTrace::Load(trace_name, loaded));
+  EXPECT_EQ(trace.GetPageIds(), loaded);
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+  remove(trace_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, NewPagesTest) {
+  const std::string db_name = "bpm_test.db";
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(2, 8, disk_manager);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(page_id));
+
+  // Scenario: the pages of a run have consecutive ids and are spread over the shards.
+  auto pages = bpm->NewPages(4);
+  ASSERT_EQ(4, pages.size());
+  for (page_id_t i = 0; i < 4; i++) {
+    EXPECT_EQ(page_id + 1 + i, pages[i]->GetPageId());
+    EXPECT_EQ(1, pages[i]->GetPinCount());
+  }
+
+  // Scenario: a run which does not fit in the free frames creates nothing and gives its page ids back.
+  EXPECT_TRUE(bpm->NewPages(4).empty());
+  EXPECT_TRUE(bpm->IsPageFree(page_id + 5));
+  bpm->UnpinPage(page_id, false);
+  for (auto page : pages) {
+    bpm->UnpinPage(page->GetPageId(), true);
+  }
+  EXPECT_EQ(page_id + 5, bpm->NewPages(2)[0]->GetPageId());
+  bpm->UnpinPage(page_id + 5, false);
+  bpm->UnpinPage(page_id + 6, false);
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
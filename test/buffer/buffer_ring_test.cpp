@@ -0,0 +1,127 @@
+#include "buffer/buffer_ring.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+static const std::string db_name = "buffer_ring_test.db";
+
+/**
+ * Create num_pages pages, each holding its own page id, and leave them unpinned.
+ */
+static std::vector<page_id_t> CreatePages(BufferPoolManager *bpm, int num_pages) {
+  std::vector<page_id_t> page_ids(num_pages);
+  for (auto &page_id : page_ids) {
+    Page *page = bpm->NewPage(page_id);
+    EXPECT_NE(nullptr, page);
+    memcpy(page->GetData(), &page_id, sizeof(page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+  return page_ids;
+}
+
+static void ScanPages(BufferPoolManager *bpm, const std::vector<page_id_t> &page_ids, BufferRing *ring) {
+  for (auto page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id, ring);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, memcmp(page->GetData(), &page_id, sizeof(page_id)));
+    bpm->UnpinPage(page_id, false);
+  }
+}
+
+TEST(BufferRingTest, ScanKeepsWorkingSetTest) {
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(32, disk_manager);
+  auto hot = CreatePages(bpm, 16);
+  auto table = CreatePages(bpm, 200);
+  ScanPages(bpm, hot, nullptr);
+
+  // Scenario: a scan through a ring of 4 frames leaves every hot page resident.
+  {
+    auto ring = bpm->NewBufferRing(4);
+    ScanPages(bpm, table, ring.get());
+  }
+  uint64_t reads = disk_manager->GetNumReads();
+  ScanPages(bpm, hot, nullptr);
+  EXPECT_EQ(reads, disk_manager->GetNumReads());
+
+  // Scenario: the same scan without a ring evicts them.
+  ScanPages(bpm, table, nullptr);
+  reads = disk_manager->GetNumReads();
+  ScanPages(bpm, hot, nullptr);
+  EXPECT_EQ(reads + hot.size(), disk_manager->GetNumReads());
+
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferRingTest, PinnedFrameTest) {
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(8, disk_manager);
+  auto table = CreatePages(bpm, 50);
+  auto ring = bpm->NewBufferRing(2);
+
+  // Scenario: a page read into the ring which is still pinned is not recycled, the ring takes another frame.
+  Page *pinned = bpm->FetchPage(table[0], ring.get());
+  ASSERT_NE(nullptr, pinned);
+  ScanPages(bpm, table, ring.get());
+  EXPECT_EQ(table[0], pinned->GetPageId());
+  EXPECT_EQ(0, memcmp(pinned->GetData(), &table[0], sizeof(page_id_t)));
+  EXPECT_TRUE(bpm->UnpinPage(table[0], false));
+
+  // Scenario: a dirty page in the ring is written back when its frame is recycled.
+  Page *page = bpm->FetchPage(table[1], ring.get());
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData() + sizeof(page_id_t), 16, "dirty");
+  bpm->UnpinPage(table[1], true);
+  ScanPages(bpm, table, ring.get());
+  page = bpm->FetchPage(table[1]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_STREQ("dirty", page->GetData() + sizeof(page_id_t));
+  bpm->UnpinPage(table[1], false);
+
+  // Scenario: every frame of the pool is still usable once the ring is gone.
+  ring.reset();
+  std::vector<Page *> pages;
+  for (int i = 0; i < 8; i++) {
+    pages.push_back(bpm->FetchPage(table[i]));
+    ASSERT_NE(nullptr, pages.back());
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(table[8]));
+  for (int i = 0; i < 8; i++) {
+    bpm->UnpinPage(table[i], false);
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferRingTest, ParallelBufferPoolTest) {
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(4, 64, disk_manager);
+  auto hot = CreatePages(bpm, 32);
+  auto table = CreatePages(bpm, 400);
+  ScanPages(bpm, hot, nullptr);
+  {
+    auto ring = bpm->NewBufferRing(8);
+    ScanPages(bpm, table, ring.get());
+  }
+  uint64_t reads = disk_manager->GetNumReads();
+  ScanPages(bpm, hot, nullptr);
+  EXPECT_EQ(reads, disk_manager->GetNumReads());
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,55 @@
+#include "buffer/frame_arena.h"
+
+#include <cstdint>
+#include <cstdio>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+TEST(FrameArenaTest, SampleTest) {
+  FrameArena empty(0);
+  EXPECT_EQ(nullptr, empty.GetData());
+  EXPECT_EQ(FrameArenaBacking::kNone, empty.GetBacking());
+
+  FrameArena small(4);
+  EXPECT_EQ(FrameArenaBacking::kRegularPages, small.GetBacking());
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(small.GetData()) % DIRECT_IO_ALIGNMENT);
+  EXPECT_EQ(small.GetData() + 3 * PAGE_SIZE, small.GetFrame(3));
+
+  // Scenario: a large arena starts at a huge page boundary, whichever way it is backed, and is zeroed.
+  const size_t num_frames = 2 * HUGE_PAGE_SIZE / PAGE_SIZE + 1;
+  FrameArena large(num_frames);
+  EXPECT_NE(FrameArenaBacking::kNone, large.GetBacking());
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(large.GetData()) % HUGE_PAGE_SIZE);
+  for (size_t i = 0; i < num_frames; i++) {
+    EXPECT_EQ(0, large.GetFrame(i)[PAGE_SIZE - 1]);
+    large.GetFrame(i)[PAGE_SIZE - 1] = 1;
+  }
+}
+
+TEST(FrameArenaTest, BufferPoolLayoutTest) {
+  const std::string db_name = "frame_arena_test.db";
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE / DEFAULT_BUFFER_POOL_INSTANCES, disk_manager);
+  EXPECT_NE(FrameArenaBacking::kNone, bpm->GetFrameBacking());
+
+  // Scenario: descriptors start on cache lines and frames on pages, consecutive frames are adjacent.
+  page_id_t page_id;
+  Page *first = bpm->NewPage(page_id);
+  Page *second = bpm->NewPage(page_id);
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(first) % CACHELINE_SIZE);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(second) % CACHELINE_SIZE);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(first->GetData()) % PAGE_SIZE);
+  EXPECT_EQ(PAGE_SIZE, std::abs(second->GetData() - first->GetData()));
+  EXPECT_EQ(0, first->GetData()[0]);
+  bpm->UnpinPage(first->GetPageId(), false);
+  bpm->UnpinPage(second->GetPageId(), false);
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,148 @@
+#include "buffer/lru_k_replacer.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: access and unpin six frames once each.
+  for (frame_id_t i = 1; i <= 6; i++) {
+    lru_k_replacer.Pin(i);
+    lru_k_replacer.Unpin(i);
+  }
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Scenario: a second access gives frames 1 and 2 a finite backward 2-distance.
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+
+  // Scenario: frames accessed only once go first, least recently used first.
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(4, value);
+
+  // Scenario: a pinned frame is not a candidate.
+  lru_k_replacer.Pin(5);
+  EXPECT_EQ(3, lru_k_replacer.Size());
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(6, value);
+
+  // Scenario: among frames with two accesses, the one with the oldest second most recent access goes first.
+  lru_k_replacer.Unpin(5);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(5, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, lru_k_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, CorrelatedAccessTest) {
+  LRUKReplacer lru_k_replacer(3, 2);
+
+  // Scenario: back-to-back accesses to frame 0 are one reference, frame 1 gets two separate references.
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+
+  // Scenario: a removed frame starts over without history.
+  lru_k_replacer.Remove(1);
+  EXPECT_EQ(0, lru_k_replacer.Size());
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+}
+
+/**
+ * Replay a mix of B+ tree point lookups (root, internal, leaf) and full table scans, each scanned page being fetched
+ * once per tuple, against a buffer pool which holds the whole index but only a fraction of the table. The hit ratios
+ * of the policies on this mix are printed by the "scan+lookup" trace of replacer_benchmark.
+ */
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  const std::string db_name = "lru_k_replacer_test.db";
+  const size_t pool_size = 64;
+  const int num_internal = 8;
+  const int num_leaves = 40;
+  const int num_table_pages = 512;
+  const int tuples_per_page = 4;
+  const int lookups_per_round = 200;
+  const int num_rounds = 10;
+
+  // hit ratio of the index pages under LRU, CLOCK and LRU-2
+  std::vector<double> lookup_hit_ratios;
+  for (ReplacerType policy : {ReplacerType::kLRU, ReplacerType::kClock, ReplacerType::kLRUK}) {
+    remove(db_name.c_str());
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(pool_size, disk_manager, policy);
+    const int num_pages = 1 + num_internal + num_leaves + num_table_pages;
+    std::vector<page_id_t> page_ids(num_pages);
+    for (auto &page_id : page_ids) {
+      ASSERT_NE(nullptr, bpm->NewPage(page_id));
+      bpm->UnpinPage(page_id, true);
+    }
+    page_id_t root = page_ids[0];
+    auto internal = page_ids.begin() + 1;
+    auto leaves = internal + num_internal;
+    auto table = leaves + num_leaves;
+
+    auto access = [&](page_id_t page_id) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+      bpm->UnpinPage(page_id, false);
+    };
+    std::mt19937 rng(15445);
+    uint64_t lookup_accesses = 0, lookup_misses = 0;
+    for (int round = 0; round < num_rounds; round++) {
+      uint64_t reads = disk_manager->GetNumReads();
+      for (int i = 0; i < lookups_per_round; i++) {
+        access(root);
+        access(internal[rng() % num_internal]);
+        access(leaves[rng() % num_leaves]);
+      }
+      lookup_accesses += 3 * lookups_per_round;
+      lookup_misses += disk_manager->GetNumReads() - reads;
+      for (int i = 0; i < num_table_pages; i++) {
+        for (int j = 0; j < tuples_per_page; j++) {
+          access(table[i]);
+        }
+      }
+    }
+    lookup_hit_ratios.push_back(1.0 - static_cast<double>(lookup_misses) / lookup_accesses);
+    EXPECT_TRUE(bpm->CheckAllUnpinned());
+    delete bpm;
+    disk_manager->Close();
+    delete disk_manager;
+  }
+  remove(db_name.c_str());
+
+  // the scans wipe the index out of an LRU pool, LRU-K keeps it resident
+  EXPECT_GT(lookup_hit_ratios[2], lookup_hit_ratios[0]);
+  EXPECT_GT(lookup_hit_ratios[2], 0.95);
+}
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/page_table.h"
+#include "gtest/gtest.h"
+
+/**
+ * Hit latency of the page table alone: the old std::unordered_map lookup (count() followed by operator[]) against a
+ * single PageTable::Find, for a full default-sized pool and a random access pattern.
+ */
+TEST(PageTableBenchmark, HitLatency) {
+  const size_t num_frames = DEFAULT_BUFFER_POOL_SIZE;
+  const size_t num_lookups = 20000000;
+
+  std::unordered_map<page_id_t, frame_id_t> map;
+  PageTable page_table(num_frames);
+  for (size_t i = 0; i < num_frames; i++) {
+    // resident pages are spread over a larger file, as in a warmed up pool
+    page_id_t page_id = static_cast<page_id_t>(i * 7);
+    map[page_id] = static_cast<frame_id_t>(i);
+    page_table.Insert(page_id, static_cast<frame_id_t>(i));
+  }
+  std::vector<page_id_t> keys(1 << 16);
+  std::mt19937 rng(42);
+  for (auto &key : keys) {
+    key = static_cast<page_id_t>(rng() % num_frames * 7);
+  }
+  const size_t key_mask = keys.size() - 1;
+
+  int64_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_lookups; i++) {
+    page_id_t page_id = keys[i & key_mask];
+    if (map.count(page_id) != 0) {
+      checksum += map[page_id];
+    }
+  }
+  std::chrono::duration<double, std::nano> map_time = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_lookups; i++) {
+    frame_id_t frame_id;
+    if (page_table.Find(keys[i & key_mask], frame_id)) {
+      checksum -= frame_id;
+    }
+  }
+  std::chrono::duration<double, std::nano> table_time = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(0, checksum);
+
+  printf("%-28s %10s\n", "page table", "ns/hit");
+  printf("%-28s %10.2f\n", "unordered_map count + []", map_time.count() / num_lookups);
+  printf("%-28s %10.2f\n", "PageTable::Find", table_time.count() / num_lookups);
+}
+
+/**
+ * End to end hit latency of FetchPage + UnpinPage on a resident page.
+ */
+TEST(PageTableBenchmark, BufferPoolHitLatency) {
+  const std::string db_name = "page_table_benchmark.db";
+  const int num_pages = 4096;
+  const size_t num_ops = 5000000;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(num_pages, disk_manager);
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+  std::mt19937 rng(42);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_ops; i++) {
+    page_id_t page_id = rng() % num_pages;
+    bpm->FetchPage(page_id);
+    bpm->UnpinPage(page_id, false);
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  printf("%-28s %10.2f\n", "FetchPage + UnpinPage", elapsed.count() / num_ops);
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
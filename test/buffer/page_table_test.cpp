@@ -0,0 +1,104 @@
+#include "buffer/page_table.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(4);
+  EXPECT_EQ(8, page_table.Capacity());
+  frame_id_t frame_id;
+  EXPECT_FALSE(page_table.Find(0, frame_id));
+
+  page_table.Insert(0, 3);
+  page_table.Insert(8, 1);
+  page_table.Insert(16, 2);
+  EXPECT_EQ(3, page_table.Size());
+  ASSERT_TRUE(page_table.Find(8, frame_id));
+  EXPECT_EQ(1, frame_id);
+
+  // Scenario: inserting an existing page only updates its frame.
+  page_table.Insert(8, 0);
+  EXPECT_EQ(3, page_table.Size());
+  ASSERT_TRUE(page_table.Find(8, frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  EXPECT_TRUE(page_table.Erase(0));
+  EXPECT_FALSE(page_table.Erase(0));
+  EXPECT_FALSE(page_table.Find(0, frame_id));
+  ASSERT_TRUE(page_table.Find(16, frame_id));
+  EXPECT_EQ(2, frame_id);
+  EXPECT_EQ(2, page_table.Size());
+}
+
+TEST(PageTableTest, RandomOperationTest) {
+  const size_t num_frames = 1024;
+  PageTable page_table(num_frames);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  std::mt19937 rng(2023);
+  std::uniform_int_distribution<page_id_t> page_dist(0, 4 * num_frames);
+  for (int i = 0; i < 200000; i++) {
+    page_id_t page_id = page_dist(rng);
+    if (expected.size() < num_frames && rng() % 2 == 0) {
+      page_table.Insert(page_id, i);
+      expected[page_id] = i;
+    } else {
+      EXPECT_EQ(expected.erase(page_id) == 1, page_table.Erase(page_id));
+    }
+  }
+  ASSERT_EQ(expected.size(), page_table.Size());
+  for (page_id_t page_id = 0; page_id <= static_cast<page_id_t>(4 * num_frames); page_id++) {
+    frame_id_t frame_id;
+    auto iter = expected.find(page_id);
+    ASSERT_EQ(iter != expected.end(), page_table.Find(page_id, frame_id));
+    if (iter != expected.end()) {
+      EXPECT_EQ(iter->second, frame_id);
+    }
+  }
+  size_t visited = 0;
+  page_table.ForEach([&](page_id_t page_id, frame_id_t frame_id) {
+    EXPECT_EQ(expected[page_id], frame_id);
+    visited++;
+  });
+  EXPECT_EQ(expected.size(), visited);
+}
+
+TEST(PageTableTest, ConcurrentReadTest) {
+  // Readers look up pages that are never erased while a writer churns other pages. A lookup may miss a page that
+  // is being shifted, but it must never return a wrong frame.
+  const page_id_t num_stable = 256;
+  PageTable page_table(1024);
+  for (page_id_t i = 0; i < num_stable; i++) {
+    page_table.Insert(i, i);
+  }
+  std::atomic<bool> stop{false};
+  std::atomic<int> errors{0};
+  std::thread writer([&] {
+    std::mt19937 rng(7);
+    for (int i = 0; i < 200000; i++) {
+      page_id_t page_id = num_stable + rng() % 700;
+      if (rng() % 2 == 0) {
+        page_table.Insert(page_id, page_id);
+      } else {
+        page_table.Erase(page_id);
+      }
+    }
+    stop = true;
+  });
+  std::thread reader([&] {
+    while (!stop) {
+      for (page_id_t i = 0; i < num_stable; i++) {
+        frame_id_t frame_id = INVALID_FRAME_ID;
+        if (page_table.Find(i, frame_id) && frame_id != i) {
+          errors++;
+        }
+      }
+    }
+  });
+  writer.join();
+  reader.join();
+  EXPECT_EQ(0, errors);
+}
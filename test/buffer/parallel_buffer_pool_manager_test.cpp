@@ -0,0 +1,116 @@
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(ParallelBufferPoolManagerTest, ShardingTest) {
+  const std::string db_name = "pbpm_test.db";
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 10;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+
+  // Scenario: shards get 3, 3, 2, 2 frames. Pages are dealt round robin, so shards 2 and 3 fill up first.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 8; ++i) {
+    auto *page = bpm->NewPage(page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(i, page_id_temp);
+    EXPECT_EQ(bpm->GetInstance(page_id_temp)->FetchPage(page_id_temp), page);
+    bpm->GetInstance(page_id_temp)->UnpinPage(page_id_temp, false);
+    snprintf(page->GetData(), PAGE_SIZE, "page-%d", page_id_temp);
+  }
+  EXPECT_NE(nullptr, bpm->NewPage(page_id_temp));
+  EXPECT_EQ(8, page_id_temp);
+  EXPECT_NE(nullptr, bpm->NewPage(page_id_temp));
+  EXPECT_EQ(9, page_id_temp);
+
+  // Scenario: page 10 belongs to the full shard 2, the allocation must be rolled back.
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id_temp));
+  EXPECT_EQ(INVALID_PAGE_ID, page_id_temp);
+  EXPECT_TRUE(bpm->IsPageFree(10));
+
+  // Scenario: after unpinning the pages of shards 2 and 3 we can allocate again, and evicted pages come back from
+  // disk with their content.
+  for (page_id_t i : {2, 6, 3, 7}) {
+    EXPECT_TRUE(bpm->UnpinPage(i, true));
+  }
+  EXPECT_NE(nullptr, bpm->NewPage(page_id_temp));
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  char expected[PAGE_SIZE];
+  for (page_id_t i : {2, 6, 3, 7}) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, PAGE_SIZE, "page-%d", i);
+    EXPECT_STREQ(expected, page->GetData());
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  for (page_id_t i : {0, 1, 4, 5, 8, 9}) {
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  EXPECT_TRUE(bpm->DeletePage(6));
+  EXPECT_TRUE(bpm->IsPageFree(6));
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(ParallelBufferPoolManagerTest, ConcurrentFetchTest) {
+  const std::string db_name = "pbpm_concurrent_test.db";
+  const size_t num_threads = 4;
+  const int num_pages = 200;
+  const int rounds = 20;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  // a small pool makes the threads evict each other's pages
+  auto *bpm = new ParallelBufferPoolManager(4, 64, disk_manager);
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(i, page_id);
+    memcpy(page->GetData(), &page_id, sizeof(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  std::vector<std::thread> threads;
+  std::vector<int> errors(num_threads, 0);
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int r = 0; r < rounds; r++) {
+        for (page_id_t i = t; i < num_pages; i += num_threads) {
+          auto *page = bpm->FetchPage(i);
+          if (page == nullptr || memcmp(page->GetData(), &i, sizeof(i)) != 0) {
+            errors[t]++;
+          }
+          if (page != nullptr) {
+            bpm->UnpinPage(i, false);
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 0; t < num_threads; t++) {
+    EXPECT_EQ(0, errors[t]);
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
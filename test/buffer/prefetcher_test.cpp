@@ -0,0 +1,201 @@
+#include "buffer/prefetcher.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/comparator.h"
+#include "storage/table_heap.h"
+
+static const std::string db_name = "prefetcher_test.db";
+
+/**
+ * Create num_pages pages, each holding its own page id. Only the last ones stay resident when num_pages is larger than
+ * the pool.
+ */
+static std::vector<page_id_t> CreatePages(BufferPoolManager *bpm, int num_pages) {
+  std::vector<page_id_t> page_ids(num_pages);
+  for (auto &page_id : page_ids) {
+    Page *page = bpm->NewPage(page_id);
+    EXPECT_NE(nullptr, page);
+    memcpy(page->GetData(), &page_id, sizeof(page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+  return page_ids;
+}
+
+static bool WaitUntilReady(BufferPoolManager *bpm, const std::vector<page_id_t> &page_ids) {
+  for (int i = 0; i < 1000; i++) {
+    bool ready = true;
+    for (auto page_id : page_ids) {
+      ready = ready && bpm->IsPageReady(page_id);
+    }
+    if (ready) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+TEST(PrefetcherTest, PrefetchPagesTest) {
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(64, disk_manager);
+  auto page_ids = CreatePages(bpm, 200);
+  std::vector<page_id_t> cold(page_ids.begin(), page_ids.begin() + 32);
+  for (auto page_id : cold) {
+    EXPECT_FALSE(bpm->IsPageReady(page_id));
+  }
+
+  // Scenario: without the I/O threads, prefetching is a no-op.
+  uint64_t reads = disk_manager->GetNumReads();
+  bpm->PrefetchPages(cold);
+  EXPECT_EQ(reads, disk_manager->GetNumReads());
+
+  // Scenario: the I/O threads read every page once, and fetching them afterwards does no I/O.
+  bpm->StartPrefetcher(2);
+  bpm->PrefetchPages(cold);
+  ASSERT_TRUE(WaitUntilReady(bpm, cold));
+  EXPECT_EQ(reads + cold.size(), disk_manager->GetNumReads());
+  for (auto page_id : cold) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, memcmp(page->GetData(), &page_id, sizeof(page_id)));
+    bpm->UnpinPage(page_id, false);
+  }
+  EXPECT_EQ(reads + cold.size(), disk_manager->GetNumReads());
+
+  // Scenario: fetching pages while they are being prefetched reads each of them once and returns its content.
+  std::vector<page_id_t> racing(page_ids.begin() + 40, page_ids.begin() + 80);
+  reads = disk_manager->GetNumReads();
+  bpm->PrefetchPages(racing);
+  for (auto page_id : racing) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, memcmp(page->GetData(), &page_id, sizeof(page_id)));
+    bpm->UnpinPage(page_id, false);
+  }
+  bpm->StopPrefetcher();
+  EXPECT_EQ(reads + racing.size(), disk_manager->GetNumReads());
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(PrefetcherTest, BufferRingTest) {
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(4, 64, disk_manager);
+  auto page_ids = CreatePages(bpm, 300);
+  bpm->StartPrefetcher(4);
+
+  // Scenario: a ring is destroyed while many read-ahead requests referring to it are queued.
+  for (int round = 0; round < 10; round++) {
+    auto ring = bpm->NewBufferRing(8);
+    bpm->PrefetchPages(page_ids, ring.get());
+  }
+
+  // Scenario: pages read ahead through a ring are found by a scan through the same ring.
+  auto ring = bpm->NewBufferRing(16);
+  std::vector<page_id_t> ahead(page_ids.begin(), page_ids.begin() + 8);
+  bpm->PrefetchPages(ahead, ring.get());
+  ASSERT_TRUE(WaitUntilReady(bpm, ahead));
+  uint64_t reads = disk_manager->GetNumReads();
+  for (auto page_id : ahead) {
+    Page *page = bpm->FetchPage(page_id, ring.get());
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, memcmp(page->GetData(), &page_id, sizeof(page_id)));
+    bpm->UnpinPage(page_id, false);
+  }
+  EXPECT_EQ(reads, disk_manager->GetNumReads());
+  ring.reset();
+  bpm->StopPrefetcher();
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(PrefetcherTest, ScanReadAheadTest) {
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(4, 64, disk_manager);
+  bpm->StartPrefetcher();
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 256, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+  const int row_nums = 2000;
+  char name[256];
+  memset(name, 'x', sizeof(name));
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, sizeof(name), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+
+  // Scenario: a bulk read scan with read-ahead sees every row once, in insertion order.
+  for (bool bulk_read : {false, true}) {
+    int expected = 0;
+    for (auto iter = table_heap->Begin(nullptr, bulk_read); iter != table_heap->End(); ++iter) {
+      Row row(iter->GetRowId());
+      ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+      ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, expected)));
+      expected++;
+    }
+    EXPECT_EQ(row_nums, expected);
+  }
+  // Scenario: read-ahead follows the page chain when the scan moves to another page, not for every tuple.
+  PageAccessTrace trace;
+  bpm->SetAccessTrace(&trace);
+  int rows = 0;
+  for (auto iter = table_heap->Begin(nullptr, true); iter != table_heap->End(); ++iter) {
+    rows++;
+  }
+  bpm->SetAccessTrace(nullptr);
+  auto accesses = trace.GetPageIds();
+  size_t num_pages = std::set<page_id_t>(accesses.begin(), accesses.end()).size();
+  EXPECT_EQ(row_nums, rows);
+  // one fetch per tuple, one more per page, and one page of the chain looked up per page once the queue is full
+  EXPECT_LE(accesses.size(), row_nums + 2 * num_pages + 2 * DEFAULT_READ_AHEAD_PAGES);
+  bpm->StopPrefetcher();
+  delete table_heap;
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(PrefetcherTest, IndexReadAheadTest) {
+  DBStorageEngine engine(db_name, true, 256);
+  std::vector<Column *> columns = {new Column("int", TypeId::kTypeInt, 0, false, false)};
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 16);
+  BPlusTree tree(0, engine.bpm_, KP);
+  const int key_nums = 20000;
+  for (int i = 0; i < key_nums; i++) {
+    GenericKey *key = KP.InitKey();
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+    tree.Insert(key, RowId(i), nullptr);
+    free(key);
+  }
+  // Scenario: a range scan with read-ahead of the following leaves sees every key once, in order.
+  int expected = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    ASSERT_EQ(RowId(expected), (*iter).second);
+    expected++;
+  }
+  EXPECT_EQ(key_nums, expected);
+  delete table_schema;
+}
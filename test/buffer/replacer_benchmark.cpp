@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/page_access_trace.h"
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/comparator.h"
+#include "storage/table_heap.h"
+
+/**
+ * The std::list based LRUReplacer the array based one replaced, kept to compare against.
+ */
+class ListLRUReplacer : public Replacer {
+ public:
+  explicit ListLRUReplacer(size_t num_pages) : cache_(num_pages, lru_list_.end()), num_pages_(num_pages) {}
+
+  bool Victim(frame_id_t *frame_id) override {
+    if (lru_list_.empty()) {
+      return false;
+    }
+    *frame_id = lru_list_.back();
+    cache_[*frame_id] = lru_list_.end();
+    lru_list_.pop_back();
+    return true;
+  }
+
+  void Pin(frame_id_t frame_id) override {
+    if (cache_[frame_id] != lru_list_.end()) {
+      lru_list_.erase(cache_[frame_id]);
+      cache_[frame_id] = lru_list_.end();
+    }
+  }
+
+  void Unpin(frame_id_t frame_id) override {
+    if (lru_list_.size() >= num_pages_ || cache_[frame_id] != lru_list_.end()) {
+      return;
+    }
+    lru_list_.push_front(frame_id);
+    cache_[frame_id] = lru_list_.begin();
+  }
+
+  void SetCapacity([[maybe_unused]] size_t num_pages) override {}
+
+  size_t Size() override { return lru_list_.size(); }
+
+ private:
+  std::list<frame_id_t> lru_list_;
+  std::vector<std::list<frame_id_t>::iterator> cache_;
+  size_t num_pages_;
+};
+
+/**
+ * The std::list and std::map based CLOCKReplacer the array based one replaced, kept to compare against.
+ */
+class ListCLOCKReplacer : public Replacer {
+ public:
+  explicit ListCLOCKReplacer(size_t num_pages) : capacity_(num_pages) {}
+
+  bool Victim(frame_id_t *frame_id) override {
+    while (!clock_list_.empty()) {
+      frame_id_t frame = clock_list_.front();
+      clock_list_.pop_front();
+      if (clock_status_[frame] != 0) {
+        clock_status_[frame] = 0;
+        clock_list_.push_back(frame);
+        continue;
+      }
+      clock_status_.erase(frame);
+      *frame_id = frame;
+      return true;
+    }
+    return false;
+  }
+
+  void Pin(frame_id_t frame_id) override {
+    if (clock_status_.erase(frame_id) != 0) {
+      clock_list_.remove(frame_id);
+    }
+  }
+
+  void Unpin(frame_id_t frame_id) override {
+    if (clock_status_.count(frame_id) != 0 || clock_list_.size() >= capacity_) {
+      return;
+    }
+    clock_list_.push_back(frame_id);
+    clock_status_[frame_id] = 1;
+  }
+
+  void SetCapacity([[maybe_unused]] size_t num_pages) override {}
+
+  size_t Size() override { return clock_list_.size(); }
+
+ private:
+  size_t capacity_;
+  std::list<frame_id_t> clock_list_;
+  std::map<frame_id_t, frame_id_t> clock_status_;
+};
+
+struct ReplayResult {
+  double hit_ratio;
+  double ns_per_op;
+};
+
+/**
+ * Replay a trace against a replacer the way BufferPoolManager drives it: every access pins the page's frame and
+ * unpins it at once, and a miss takes a free frame or the replacer's victim.
+ */
+static ReplayResult Replay(const std::vector<page_id_t> &trace, Replacer *replacer, size_t pool_size) {
+  page_id_t max_page_id = 0;
+  for (auto page_id : trace) {
+    max_page_id = std::max(max_page_id, page_id);
+  }
+  std::vector<frame_id_t> frame_of(max_page_id + 1, INVALID_FRAME_ID);
+  std::vector<page_id_t> page_of(pool_size, INVALID_PAGE_ID);
+  size_t next_free = 0;
+  size_t hits = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (auto page_id : trace) {
+    frame_id_t frame_id = frame_of[page_id];
+    if (frame_id != INVALID_FRAME_ID) {
+      hits++;
+    } else {
+      if (next_free < pool_size) {
+        frame_id = static_cast<frame_id_t>(next_free++);
+      } else {
+        EXPECT_TRUE(replacer->Victim(&frame_id));
+        frame_of[page_of[frame_id]] = INVALID_FRAME_ID;
+      }
+      frame_of[page_id] = frame_id;
+      page_of[frame_id] = page_id;
+    }
+    replacer->Pin(frame_id);
+    replacer->Unpin(frame_id);
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return {static_cast<double>(hits) / trace.size(), elapsed.count() / trace.size()};
+}
+
+/**
+ * Point lookups of rows, 80% of them on 20% of the table, interrupted by full scans which touch every page once.
+ */
+static std::vector<page_id_t> RecordTableTrace(BufferPoolManager *bpm) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 256, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+  const int row_nums = 20000;
+  char name[256];
+  memset(name, 'x', sizeof(name));
+  std::vector<RowId> row_ids;
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, sizeof(name), true)};
+    Row row(fields);
+    EXPECT_TRUE(table_heap->InsertTuple(row, nullptr));
+    row_ids.push_back(row.GetRowId());
+  }
+
+  PageAccessTrace trace;
+  bpm->SetAccessTrace(&trace);
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int> hot(0, row_nums / 5 - 1);
+  std::uniform_int_distribution<int> any(0, row_nums - 1);
+  std::uniform_int_distribution<int> percent(0, 99);
+  for (int round = 0; round < 4; round++) {
+    for (int i = 0; i < 50000; i++) {
+      Row row(row_ids[percent(rng) < 80 ? hot(rng) : any(rng)]);
+      EXPECT_TRUE(table_heap->GetTuple(&row, nullptr));
+    }
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    }
+  }
+  bpm->SetAccessTrace(nullptr);
+  delete table_heap;
+  return trace.GetPageIds();
+}
+
+/**
+ * Zipf-like key lookups in a B+ tree, which favor its inner pages, interrupted by range scans over its leaves.
+ */
+static std::vector<page_id_t> RecordIndexTrace(BufferPoolManager *bpm) {
+  std::vector<Column *> columns = {new Column("int", TypeId::kTypeInt, 0, false, false)};
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 16);
+  BPlusTree tree(0, bpm, KP);
+  const int key_nums = 100000;
+  GenericKey *key = KP.InitKey();
+  for (int i = 0; i < key_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+    tree.Insert(key, RowId(i), nullptr);
+  }
+
+  PageAccessTrace trace;
+  bpm->SetAccessTrace(&trace);
+  std::mt19937 rng(0);
+  std::exponential_distribution<double> skew(8.0 / key_nums);
+  std::vector<RowId> result;
+  for (int round = 0; round < 4; round++) {
+    for (int i = 0; i < 50000; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, static_cast<int>(skew(rng)) % key_nums)};
+      KP.SerializeFromKey(key, Row(fields), table_schema);
+      result.clear();
+      tree.GetValue(key, result, nullptr);
+    }
+    for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    }
+  }
+  bpm->SetAccessTrace(nullptr);
+  free(key);
+  delete table_schema;
+  return trace.GetPageIds();
+}
+
+/**
+ * The mix of LRUKReplacerTest.ScanResistanceTest: B+ tree point lookups (root, internal, leaf) and full table scans
+ * which fetch every page once per tuple, over 8 internal pages, 40 leaves and 512 table pages.
+ */
+static std::vector<page_id_t> MakeScanLookupTrace() {
+  const int num_internal = 8;
+  const int num_leaves = 40;
+  const int num_table_pages = 512;
+  const page_id_t root = 0, internal = 1, leaves = internal + num_internal, table = leaves + num_leaves;
+  std::vector<page_id_t> page_ids;
+  std::mt19937 rng(15445);
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < 200; i++) {
+      page_ids.push_back(root);
+      page_ids.push_back(internal + rng() % num_internal);
+      page_ids.push_back(leaves + rng() % num_leaves);
+    }
+    for (int i = 0; i < num_table_pages; i++) {
+      page_ids.insert(page_ids.end(), 4, table + i);
+    }
+  }
+  return page_ids;
+}
+
+/**
+ * Replay page access traces recorded from a table workload and an index workload, the scan and lookup mix of the
+ * LRU-K test, and the trace saved by PageAccessTrace::Save() in the file named by MINISQL_REPLACER_TRACE if it is set,
+ * against every replacement policy at several pool sizes.
+ */
+TEST(ReplacerBenchmark, TraceReplay) {
+  const std::string db_name = "replacer_benchmark.db";
+  std::vector<std::pair<std::string, std::vector<page_id_t>>> traces;
+  {
+    DBStorageEngine engine(db_name, true, DEFAULT_BUFFER_POOL_SIZE, 1);
+    traces.emplace_back("table", RecordTableTrace(engine.bpm_));
+    traces.emplace_back("index", RecordIndexTrace(engine.bpm_));
+  }
+  traces.emplace_back("scan+lookup", MakeScanLookupTrace());
+  remove(("./databases/" + db_name).c_str());
+  const char *trace_file = getenv("MINISQL_REPLACER_TRACE");
+  if (trace_file != nullptr) {
+    std::vector<page_id_t> page_ids;
+    ASSERT_TRUE(PageAccessTrace::Load(trace_file, page_ids));
+    traces.emplace_back(trace_file, page_ids);
+  }
+
+  std::vector<std::pair<std::string, std::function<Replacer *(size_t)>>> policies = {
+      {"LRU", [](size_t n) { return new LRUReplacer(n); }},
+      {"LRU (list)", [](size_t n) { return new ListLRUReplacer(n); }},
+      {"CLOCK", [](size_t n) { return new CLOCKReplacer(n); }},
+      {"CLOCK (list)", [](size_t n) { return new ListCLOCKReplacer(n); }},
+      {"LRU-2", [](size_t n) { return new LRUKReplacer(n); }}};
+  printf("%-12s %10s %8s %-14s %10s %10s\n", "trace", "accesses", "frames", "policy", "hit ratio", "ns/op");
+  for (auto &trace : traces) {
+    std::vector<bool> seen;
+    size_t distinct = 0;
+    for (auto page_id : trace.second) {
+      if (static_cast<size_t>(page_id) >= seen.size()) {
+        seen.resize(page_id + 1, false);
+      }
+      distinct += seen[page_id] ? 0 : 1;
+      seen[page_id] = true;
+    }
+    for (size_t divisor : {32, 16, 8, 4, 2}) {
+      size_t pool_size = std::max<size_t>(1, distinct / divisor);
+      for (auto &policy : policies) {
+        std::unique_ptr<Replacer> replacer(policy.second(pool_size));
+        ReplayResult result = Replay(trace.second, replacer.get(), pool_size);
+        printf("%-12s %10zu %8zu %-14s %10.4f %10.1f\n", trace.first.c_str(), trace.second.size(), pool_size,
+               policy.first.c_str(), result.hit_ratio, result.ns_per_op);
+      }
+    }
+  }
+}
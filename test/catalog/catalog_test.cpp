@@ -126,4 +126,34 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+TEST(CatalogTest, CatalogReadOnlyTest) {
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Txn txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-1", schema.get(), &txn, table_info));
+  const int row_nums = 2000;
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>("name"), 4, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+  }
+  delete db_01;
+
+  // Scenario: a database opened read-only serves its catalog and a full scan from the mapping, without a page read.
+  auto db_02 = new DBStorageEngine(db_file_name, false, DEFAULT_BUFFER_POOL_SIZE, DEFAULT_BUFFER_POOL_INSTANCES, true);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info));
+  int expected = 0;
+  for (auto iter = table_info->GetTableHeap()->Begin(&txn, true); iter != table_info->GetTableHeap()->End(); ++iter) {
+    Row row(iter->GetRowId());
+    ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, &txn));
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, expected)));
+    expected++;
+  }
+  EXPECT_EQ(row_nums, expected);
+  EXPECT_EQ(0, db_02->disk_mgr_->GetNumReads());
+  delete db_02;
+}
@@ -0,0 +1,87 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "executor/plans/seq_scan_plan.h"
+#include "executor/plans/update_plan.h"
+#include "executor_test_util.h"  // NOLINT
+
+// 统计整个进程中operator new的调用次数
+static std::atomic<size_t> num_allocations{0};
+
+void *operator new(size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+/**
+ * Run the statements of the ExecutorTest workloads over its 1000 row table, each with a context of its own as the
+ * engine does, with the rows of the statement in the MemHeap of the context and then allocated one by one. The
+ * allocation counts are every operator new of the process during the statements.
+ */
+TEST_F(ExecutorTest, MemHeapBenchmark) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  const Schema *schema = table_info->GetSchema();
+  auto col_id = MakeColumnValueExpression(*schema, 0, "id");
+  auto col_name = MakeColumnValueExpression(*schema, 0, "name");
+  auto out_schema = MakeOutputSchema({{"id", col_id}, {"name", col_name}});
+  auto id_below_100 = MakeComparisonExpression(col_id, MakeConstantValueExpression(Field(kTypeInt, 100)), "<");
+  auto id_below_500 = MakeComparisonExpression(col_id, MakeConstantValueExpression(Field(kTypeInt, 500)), "<");
+  std::unordered_map<uint32_t, AbstractExpressionRef> update_attrs{
+      {2, MakeConstantValueExpression(Field(kTypeFloat, 1.5f))}};
+
+  struct Workload {
+    std::string name;
+    AbstractPlanNodeRef plan;
+    size_t rows;
+  };
+  std::vector<Workload> workloads = {
+      {"select id, name where id < 100",
+       std::make_shared<SeqScanPlanNode>(out_schema, table_info->GetTableName(), id_below_100), 100},
+      {"select *", std::make_shared<SeqScanPlanNode>(schema, table_info->GetTableName()), 1000},
+      {"update set account where id < 500",
+       std::make_shared<UpdatePlanNode>(
+           schema, std::make_shared<SeqScanPlanNode>(schema, table_info->GetTableName(), id_below_500), "table-1",
+           update_attrs),
+       500}};
+
+  const int statements = 200;
+  printf("%-36s %8s %14s %18s %16s\n", "workload", "mem heap", "statements/s", "allocs/statement",
+         "heap KB/statement");
+  for (auto &workload : workloads) {
+    size_t allocs[2];
+    for (bool use_mem_heap : {false, true}) {
+      size_t heap_bytes = 0;
+      size_t start_allocations = num_allocations.load();
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < statements; i++) {
+        ExecuteContext context(GetTxn(), GetExecutorContext()->GetCatalog(),
+                               GetExecutorContext()->GetBufferPoolManager(), use_mem_heap);
+        std::vector<Row> result_set;
+        ASSERT_EQ(DB_SUCCESS, GetExecutionEngine()->ExecutePlan(workload.plan, &result_set, GetTxn(), &context));
+        ASSERT_EQ(workload.rows, result_set.size());
+        if (use_mem_heap) {
+          heap_bytes += context.GetMemHeap()->GetAllocatedBytes();
+        }
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      allocs[use_mem_heap] = (num_allocations.load() - start_allocations) / statements;
+      printf("%-36s %8s %14.0f %18zu %16.1f\n", workload.name.c_str(), use_mem_heap ? "yes" : "no",
+             statements / elapsed.count(), allocs[use_mem_heap], heap_bytes / 1024.0 / statements);
+    }
+    EXPECT_LT(allocs[true], allocs[false]);
+  }
+}
@@ -154,4 +154,15 @@ TEST_F(ExecutorTest, SimpleUpdateTest) {
     ASSERT_TRUE(row.GetField(0)->CompareEquals(Field(kTypeInt, 500)));
     ASSERT_TRUE(row.GetField(1)->CompareEquals(Field(kTypeChar, const_cast<char *>("minisql"), 7, false)));
   }
+  result_set.clear();
+
+  // Update every row in a context of its own: the rows of each tuple are scratch, so the memory of the statement
+  // does not grow with the number of rows updated
+  ExecuteContext context(GetTxn(), GetExecutorContext()->GetCatalog(), GetExecutorContext()->GetBufferPoolManager());
+  auto update_all_plan = std::make_shared<UpdatePlanNode>(
+      schema, make_shared<SeqScanPlanNode>(schema, table_info->GetTableName()), "table-1", update_attrs);
+  ASSERT_EQ(DB_SUCCESS, GetExecutionEngine()->ExecutePlan(update_all_plan, &result_set, GetTxn(), &context));
+  ASSERT_EQ(1000, result_set.size());
+  EXPECT_EQ(0, context.GetMemHeap()->GetAllocatedBytes());
+  EXPECT_EQ(1, context.GetTupleMemHeap()->GetNumBlocks());
 }
@@ -0,0 +1,133 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "index/generic_key.h"
+#include "record/field_comparator.h"
+
+/** Comparison of two keys as KeyManager::CompareKeys did before the kernels: deserialize both, compare virtually */
+static int CompareKeysVirtual(const KeyManager &manager, Schema *key_schema, const GenericKey *lhs,
+                              const GenericKey *rhs) {
+  Row lhs_key(INVALID_ROWID);
+  Row rhs_key(INVALID_ROWID);
+  manager.DeserializeToKey(lhs, lhs_key, key_schema);
+  manager.DeserializeToKey(rhs, rhs_key, key_schema);
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    if (lhs_key.GetField(i)->CompareLessThan(*rhs_key.GetField(i)) == CmpBool::kTrue) {
+      return -1;
+    }
+    if (lhs_key.GetField(i)->CompareGreaterThan(*rhs_key.GetField(i)) == CmpBool::kTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+template <typename Func>
+static double MeasureNsPerOp(size_t ops, Func &&func) {
+  auto start = std::chrono::steady_clock::now();
+  func();
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / ops;
+}
+
+/**
+ * For each type, compare random pairs of fields with lhs < rhs through the Type singleton (Field::CompareLessThan)
+ * and through the kernel selected by GetFieldComparator, then compare random single column index keys of the type
+ * by deserializing them as before and with KeyManager::CompareKeys.
+ */
+TEST(FieldComparatorBenchmark, CompareByTypeBenchmark) {
+  const size_t num_fields = 4096;
+  const int rounds = 256;
+  std::mt19937 rng(2024);
+  std::vector<std::string> words(num_fields);
+  for (auto &word : words) {
+    // 长短都有，短的存在field内
+    word.resize(4 + rng() % 12);
+    for (auto &c : word) {
+      c = 'a' + rng() % 4;
+    }
+  }
+
+  struct Workload {
+    std::string name;
+    TypeId type;
+    uint32_t length;
+  };
+  std::vector<Workload> workloads = {
+      {"int", TypeId::kTypeInt, 0}, {"float", TypeId::kTypeFloat, 0}, {"char", TypeId::kTypeChar, 16}};
+  printf("%-8s %22s %22s %22s %22s\n", "type", "virtual ns/compare", "kernel ns/compare", "old key ns/compare",
+         "key ns/compare");
+  for (auto &workload : workloads) {
+    std::vector<Field> fields;
+    fields.reserve(num_fields);
+    for (size_t i = 0; i < num_fields; i++) {
+      if (workload.type == TypeId::kTypeInt) {
+        fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(rng() % 1000));
+      } else if (workload.type == TypeId::kTypeFloat) {
+        fields.emplace_back(TypeId::kTypeFloat, static_cast<float>(rng() % 1000) / 7);
+      } else {
+        fields.emplace_back(TypeId::kTypeChar, words[i].data(), words[i].size(), true);
+      }
+    }
+
+    // field之间的比较
+    size_t ops = num_fields * rounds;
+    size_t virtual_less = 0, kernel_less = 0;
+    double virtual_ns = MeasureNsPerOp(ops, [&] {
+      for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < num_fields; i++) {
+          virtual_less += fields[i].CompareLessThan(fields[(i + r + 1) % num_fields]) == CmpBool::kTrue;
+        }
+      }
+    });
+    FieldComparator less_than = GetFieldComparator(workload.type, CompareOp::kLessThan);
+    double kernel_ns = MeasureNsPerOp(ops, [&] {
+      for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < num_fields; i++) {
+          kernel_less += less_than(fields[i], fields[(i + r + 1) % num_fields]) == CmpBool::kTrue;
+        }
+      }
+    });
+    ASSERT_EQ(virtual_less, kernel_less);
+
+    // 单列索引键之间的比较
+    std::vector<Column *> columns = {
+        workload.type == TypeId::kTypeChar ? new Column("k", workload.type, workload.length, 0, false, false)
+                                           : new Column("k", workload.type, 0, false, false)};
+    auto key_schema = std::make_shared<Schema>(columns);
+    KeyManager manager(key_schema.get(), 32);
+    std::vector<GenericKey *> keys;
+    for (auto &field : fields) {
+      std::vector<Field> key_fields{Field(field)};
+      keys.push_back(manager.InitKey());
+      manager.SerializeFromKey(keys.back(), Row(key_fields), key_schema.get());
+    }
+    size_t key_rounds = rounds / 16;
+    size_t key_ops = num_fields * key_rounds;
+    int old_sum = 0, new_sum = 0;
+    double old_key_ns = MeasureNsPerOp(key_ops, [&] {
+      for (size_t r = 0; r < key_rounds; r++) {
+        for (size_t i = 0; i < num_fields; i++) {
+          old_sum += CompareKeysVirtual(manager, key_schema.get(), keys[i], keys[(i + r + 1) % num_fields]);
+        }
+      }
+    });
+    double key_ns = MeasureNsPerOp(key_ops, [&] {
+      for (size_t r = 0; r < key_rounds; r++) {
+        for (size_t i = 0; i < num_fields; i++) {
+          new_sum += manager.CompareKeys(keys[i], keys[(i + r + 1) % num_fields]);
+        }
+      }
+    });
+    ASSERT_EQ(old_sum, new_sum);
+    for (auto key : keys) {
+      free(key);
+    }
+    printf("%-8s %22.2f %22.2f %22.2f %22.2f\n", workload.name.c_str(), virtual_ns, kernel_ns, old_key_ns, key_ns);
+  }
+}
@@ -1,10 +1,17 @@
 #include <cstring>
 
 #include "common/instance.h"
+#include "common/mem_heap.h"
 #include "gtest/gtest.h"
 #include "page/table_page.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "planner/expressions/logic_expression.h"
 #include "record/field.h"
+#include "record/field_comparator.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "record/schema.h"
 
 char *chars[] = {const_cast<char *>(""), const_cast<char *>("hello"), const_cast<char *>("world!"),
@@ -75,6 +82,102 @@ TEST(TupleTest, FieldSerializeDeserializeTest) {
   }
 }
 
+// Scenario: short CHAR fields owned by the field are stored inline, long ones on the heap, and both survive copies
+TEST(TupleTest, InlineCharTest) {
+  auto is_inline = [](const Field &field) {
+    auto begin = reinterpret_cast<const char *>(&field);
+    return field.GetData() >= begin && field.GetData() < begin + sizeof(Field);
+  };
+  char long_chars[] = "a string longer than a pointer";
+  Field short_field(TypeId::kTypeChar, chars[1], strlen(chars[1]), true);
+  Field long_field(TypeId::kTypeChar, long_chars, strlen(long_chars), true);
+  Field borrowed_field(TypeId::kTypeChar, chars[2], strlen(chars[2]), false);
+  EXPECT_TRUE(is_inline(short_field));
+  EXPECT_FALSE(is_inline(long_field));
+  EXPECT_EQ(chars[2], borrowed_field.GetData());
+  EXPECT_EQ(CmpBool::kTrue, short_field.CompareEquals(char_fields[1]));
+  EXPECT_EQ("hello", short_field.toString());
+  // 复制后的短字符串仍在新field内
+  Field short_copy(short_field);
+  EXPECT_TRUE(is_inline(short_copy));
+  EXPECT_NE(short_field.GetData(), short_copy.GetData());
+  EXPECT_EQ(CmpBool::kTrue, short_copy.CompareEquals(short_field));
+  Field long_copy(long_field);
+  EXPECT_NE(long_field.GetData(), long_copy.GetData());
+  EXPECT_EQ(CmpBool::kTrue, long_copy.CompareEquals(long_field));
+  // 交换后数据跟着field走
+  short_copy = long_copy;
+  EXPECT_EQ(long_chars, short_copy.toString());
+  EXPECT_EQ("hello", long_copy.toString());
+  EXPECT_TRUE(is_inline(long_copy));
+  // 反序列化出的短字符串同样内联
+  char buffer[64];
+  short_field.SerializeTo(buffer);
+  Field *df = nullptr;
+  Field::DeserializeFrom(buffer, TypeId::kTypeChar, &df, false);
+  EXPECT_TRUE(is_inline(*df));
+  EXPECT_EQ(CmpBool::kTrue, df->CompareEquals(short_field));
+  delete df;
+  // heap中的行只为长字符串分配数据
+  MemHeap heap;
+  Row row(&heap);
+  row.AppendField(borrowed_field);
+  size_t allocated = heap.GetAllocatedBytes();
+  row.AppendField(long_field);
+  EXPECT_TRUE(is_inline(*row.GetField(0)));
+  EXPECT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(borrowed_field));
+  EXPECT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(long_field));
+  EXPECT_GE(heap.GetAllocatedBytes() - allocated, sizeof(Field) + strlen(long_chars));
+}
+
+// Scenario: the kernels of every type and operator agree with the Field::CompareXXX methods, nulls included
+TEST(TupleTest, FieldComparatorTest) {
+  using Method = CmpBool (Field::*)(const Field &) const;
+  const std::pair<CompareOp, Method> ops[] = {{CompareOp::kEquals, &Field::CompareEquals},
+                                              {CompareOp::kNotEquals, &Field::CompareNotEquals},
+                                              {CompareOp::kLessThan, &Field::CompareLessThan},
+                                              {CompareOp::kLessThanEquals, &Field::CompareLessThanEquals},
+                                              {CompareOp::kGreaterThan, &Field::CompareGreaterThan},
+                                              {CompareOp::kGreaterThanEquals, &Field::CompareGreaterThanEquals}};
+  std::vector<std::vector<Field *>> fields_by_type = {
+      {&null_fields[0], &int_fields[0], &int_fields[1], &int_fields[2], &int_fields[3], &int_fields[4]},
+      {&null_fields[1], &float_fields[0], &float_fields[1], &float_fields[2], &float_fields[3]},
+      {&null_fields[2], &char_fields[0], &char_fields[1], &char_fields[2], &char_fields[3]}};
+  for (auto &fields : fields_by_type) {
+    TypeId type = fields[0]->GetTypeId();
+    for (auto &op : ops) {
+      FieldComparator comparator = GetFieldComparator(type, op.first);
+      ASSERT_NE(nullptr, comparator);
+      for (auto lhs : fields) {
+        for (auto rhs : fields) {
+          EXPECT_EQ((lhs->*op.second)(*rhs), comparator(*lhs, *rhs));
+        }
+      }
+    }
+  }
+  EXPECT_EQ(nullptr, GetFieldComparator(TypeId::kTypeInvalid, CompareOp::kEquals));
+  // 在序列化的行上比较的结果与比较field相同
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char lhs_buf[PAGE_SIZE], rhs_buf[PAGE_SIZE];
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      std::vector<Field> lhs_fields{Field(int_fields[i]), Field(char_fields[i]), Field(float_fields[i])};
+      std::vector<Field> rhs_fields{Field(int_fields[j]), Field(char_fields[j]), Field(float_fields[j])};
+      Row(lhs_fields).SerializeTo(lhs_buf, schema.get());
+      Row(rhs_fields).SerializeTo(rhs_buf, schema.get());
+      RowView lhs_view(lhs_buf, schema.get()), rhs_view(rhs_buf, schema.get());
+      for (uint32_t k = 0; k < 3; k++) {
+        int cmp = GetViewFieldComparator(columns[k]->GetType())(lhs_view, rhs_view, k);
+        EXPECT_EQ(lhs_fields[k].CompareLessThan(rhs_fields[k]), GetCmpBool(cmp < 0));
+        EXPECT_EQ(lhs_fields[k].CompareEquals(rhs_fields[k]), GetCmpBool(cmp == 0));
+      }
+    }
+  }
+}
+
 TEST(TupleTest, RowTest) {
   TablePage table_page;
   // create schema
@@ -100,4 +203,144 @@ TEST(TupleTest, RowTest) {
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
-}
\ No newline at end of file
+}
+TEST(TupleTest, RowViewTest) {
+  TablePage table_page;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+                               Field(TypeId::kTypeFloat, 19.99f)};
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  ASSERT_TRUE(table_page.InsertTuple(row, schema.get(), nullptr, nullptr, nullptr));
+
+  // Scenario: the view reads each field from the page, in any order.
+  RowView view;
+  ASSERT_TRUE(table_page.GetTupleView(row.GetRowId(), schema.get(), &view));
+  ASSERT_EQ(row.GetRowId(), view.GetRowId());
+  ASSERT_EQ(3, view.GetFieldCount());
+  EXPECT_EQ(19.99f, view.GetFloat(2));
+  EXPECT_EQ(188, view.GetInt(0));
+  uint32_t len;
+  const char *name = view.GetChars(1, &len);
+  EXPECT_EQ("minisql", std::string(name, len));
+  EXPECT_GE(name, table_page.GetData());
+  EXPECT_LT(name, table_page.GetData() + PAGE_SIZE);
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    EXPECT_EQ(CmpBool::kTrue, view.GetField(i).CompareEquals(fields[i]));
+  }
+
+  // Scenario: predicates evaluate on the view the same as on the row.
+  auto name_column = std::make_shared<ColumnValueExpression>(0, 1, TypeId::kTypeChar);
+  auto id_column = std::make_shared<ColumnValueExpression>(0, 0, TypeId::kTypeInt);
+  auto name_equals = std::make_shared<ComparisonExpression>(
+      name_column, std::make_shared<ConstantValueExpression>(fields[1]), "=");
+  auto id_greater = std::make_shared<ComparisonExpression>(
+      id_column, std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeInt, 188)), ">");
+  LogicExpression name_and_id(name_equals, id_greater, LogicType::And);
+  EXPECT_EQ(CmpBool::kTrue, name_equals->Evaluate(view).CompareEquals(Field(kTypeInt, 1)));
+  EXPECT_EQ(CmpBool::kFalse, name_and_id.Evaluate(view).CompareEquals(Field(kTypeInt, 1)));
+  EXPECT_EQ(CmpBool::kFalse, name_and_id.Evaluate(&row).CompareEquals(Field(kTypeInt, 1)));
+
+  // Scenario: materialized rows own their fields and outlive the tuple.
+  Row full;
+  Row projected;
+  view.Materialize(&full);
+  view.Materialize(&projected, {2, 1});
+  ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
+  table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
+  EXPECT_FALSE(table_page.GetTupleView(row.GetRowId(), schema.get(), &view));
+  ASSERT_EQ(3, full.GetFieldCount());
+  EXPECT_EQ(row.GetRowId(), full.GetRowId());
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    EXPECT_EQ(CmpBool::kTrue, full.GetField(i)->CompareEquals(fields[i]));
+  }
+  ASSERT_EQ(2, projected.GetFieldCount());
+  EXPECT_EQ(CmpBool::kTrue, projected.GetField(0)->CompareEquals(fields[2]));
+  EXPECT_EQ(CmpBool::kTrue, projected.GetField(1)->CompareEquals(fields[1]));
+
+  // Scenario: a null field takes no bytes, and the fields after it are still found.
+  Row null_row(fields);
+  delete null_row.GetFields()[1];
+  null_row.GetFields()[1] = nullptr;
+  ASSERT_TRUE(table_page.InsertTuple(null_row, schema.get(), nullptr, nullptr, nullptr));
+  ASSERT_TRUE(table_page.GetTupleView(null_row.GetRowId(), schema.get(), &view));
+  EXPECT_FALSE(view.IsNull(0));
+  EXPECT_TRUE(view.IsNull(1));
+  EXPECT_EQ(19.99f, view.GetFloat(2));
+  EXPECT_TRUE(view.GetField(1).IsNull());
+  EXPECT_EQ(CmpBool::kTrue, name_equals->Evaluate(view).CompareEquals(Field(kTypeInt, CmpBool::kNull)));
+}
+
+TEST(TupleTest, FixedLayoutTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 16, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+                               Field(TypeId::kTypeFloat, 19.99f)};
+  Schema schema(columns);
+  Row row(fields);
+  char variable[PAGE_SIZE];
+  uint32_t variable_size = row.SerializeTo(variable, &schema);
+  ASSERT_EQ(variable_size, row.GetSerializedSize(&schema));
+
+  // Scenario: the layout reserves the declared length of CHAR columns, after the same header.
+  EXPECT_FALSE(schema.CompileFixedLayout(4 + 1 + 4 + 4 + 16 + 4 - 1));
+  EXPECT_FALSE(schema.HasFixedLayout());
+  ASSERT_TRUE(schema.CompileFixedLayout(TablePage::SIZE_MAX_ROW));
+  ASSERT_EQ(4 + 1 + 4 + 4 + 16 + 4, schema.GetFixedRowSize());
+  EXPECT_EQ(5, schema.GetFixedOffset(0));
+  EXPECT_EQ(9, schema.GetFixedOffset(1));
+  EXPECT_EQ(29, schema.GetFixedOffset(2));
+
+  // Scenario: rows are written at the fixed offsets, and read back field by field in any order.
+  char fixed[PAGE_SIZE];
+  ASSERT_EQ(schema.GetFixedRowSize(), row.GetSerializedSize(&schema));
+  ASSERT_EQ(schema.GetFixedRowSize(), row.SerializeTo(fixed, &schema));
+  EXPECT_NE(0, MACH_READ_UINT32(fixed) & Row::FIXED_FORMAT_FLAG);
+  EXPECT_EQ(188, MACH_READ_INT32(fixed + schema.GetFixedOffset(0)));
+  RowView view(fixed, &schema);
+  EXPECT_EQ(19.99f, view.GetFloat(2));
+  EXPECT_EQ(188, view.GetInt(0));
+  Row fixed_row;
+  ASSERT_EQ(schema.GetFixedRowSize(), fixed_row.DeserializeFrom(fixed, &schema));
+  ASSERT_EQ(3, fixed_row.GetFieldCount());
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    EXPECT_EQ(CmpBool::kTrue, fixed_row.GetField(i)->CompareEquals(fields[i]));
+  }
+
+  // Scenario: rows written before the layout, in the variable format, are still read.
+  Row variable_row;
+  ASSERT_EQ(variable_size, variable_row.DeserializeFrom(variable, &schema));
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    EXPECT_EQ(CmpBool::kTrue, variable_row.GetField(i)->CompareEquals(fields[i]));
+  }
+  EXPECT_EQ(19.99f, RowView(variable, &schema).GetFloat(2));
+
+  // Scenario: a null field keeps its slot, and a CHAR longer than its column falls back to the variable format.
+  std::vector<Field> null_fields = {Field(TypeId::kTypeInt), Field(fields[1]), Field(fields[2])};
+  Row null_row(null_fields);
+  ASSERT_EQ(schema.GetFixedRowSize(), null_row.SerializeTo(fixed, &schema));
+  view.Reset(fixed, &schema);
+  EXPECT_TRUE(view.IsNull(0));
+  EXPECT_EQ(19.99f, view.GetFloat(2));
+  Row null_read;
+  null_read.DeserializeFrom(fixed, &schema);
+  EXPECT_TRUE(null_read.GetField(0)->IsNull());
+  EXPECT_EQ(CmpBool::kTrue, null_read.GetField(1)->CompareEquals(fields[1]));
+
+  char long_name[] = "longer than sixteen bytes";
+  std::vector<Field> long_fields = {Field(fields[0]), Field(TypeId::kTypeChar, long_name, strlen(long_name), false),
+                                    Field(fields[2])};
+  Row long_row(long_fields);
+  uint32_t long_size = long_row.SerializeTo(fixed, &schema);
+  ASSERT_EQ(long_size, long_row.GetSerializedSize(&schema));
+  EXPECT_EQ(0, MACH_READ_UINT32(fixed) & Row::FIXED_FORMAT_FLAG);
+  Row long_read;
+  ASSERT_EQ(long_size, long_read.DeserializeFrom(fixed, &schema));
+  EXPECT_EQ(CmpBool::kTrue, long_read.GetField(1)->CompareEquals(long_fields[1]));
+}
@@ -0,0 +1,65 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk_manager.h"
+
+/**
+ * Random page reads from several threads against both DiskManager backends. The file fits in the OS page cache, so
+ * the numbers show how far page I/O scales with the number of threads rather than the speed of the device.
+ */
+TEST(DiskManagerBenchmark, ConcurrentRandomRead) {
+  const std::string db_name = "disk_manager_benchmark.db";
+  const int num_pages = 16384;
+  const size_t reads_per_thread = 200000;
+
+  printf("%-10s %8s %14s %10s\n", "backend", "threads", "reads/s", "speedup");
+  for (auto backend : {DiskIOBackend::kStream, DiskIOBackend::kPread}) {
+    remove(db_name.c_str());
+    auto *disk_manager = new DiskManager(db_name, backend);
+    char buf[PAGE_SIZE];
+    for (int i = 0; i < num_pages; i++) {
+      ASSERT_EQ(i, disk_manager->AllocatePage());
+      memset(buf, i, PAGE_SIZE);
+      disk_manager->WritePage(i, buf);
+    }
+
+    double single_thread = 0;
+    for (int num_threads : {1, 2, 4, 8}) {
+      std::atomic<int64_t> checksum{0};
+      std::vector<std::thread> threads;
+      auto start = std::chrono::steady_clock::now();
+      for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+          std::mt19937 rng(t);
+          char page[PAGE_SIZE];
+          int64_t sum = 0;
+          for (size_t i = 0; i < reads_per_thread; i++) {
+            disk_manager->ReadPage(rng() % num_pages, page);
+            sum += page[0];
+          }
+          checksum += sum;
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      double throughput = num_threads * reads_per_thread / elapsed.count();
+      if (num_threads == 1) {
+        single_thread = throughput;
+      }
+      printf("%-10s %8d %14.0f %9.2fx\n", backend == DiskIOBackend::kStream ? "fstream" : "pread", num_threads,
+             throughput, throughput / single_thread);
+    }
+
+    disk_manager->Close();
+    delete disk_manager;
+  }
+  remove(db_name.c_str());
+}
@@ -1,8 +1,18 @@
 #include "storage/disk_manager.h"
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
+#include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
+#include "storage/page_codec.h"
 
 TEST(DiskManagerTest, BitMapPageTest) {
   const size_t size = 512;
@@ -32,6 +42,17 @@ TEST(DiskManagerTest, BitMapPageTest) {
     ASSERT_TRUE(bitmap->AllocatePage(ofs));
   }
   ASSERT_FALSE(bitmap->AllocatePage(ofs));
+  // Scenario: the lowest free page is allocated first, whatever order the pages were freed in.
+  ASSERT_TRUE(bitmap->DeAllocatePage(num_pages - 1));
+  ASSERT_TRUE(bitmap->DeAllocatePage(70));
+  ASSERT_TRUE(bitmap->DeAllocatePage(3));
+  ASSERT_TRUE(bitmap->AllocatePage(ofs));
+  ASSERT_EQ(3, ofs);
+  ASSERT_TRUE(bitmap->AllocatePage(ofs));
+  ASSERT_EQ(70, ofs);
+  ASSERT_TRUE(bitmap->AllocatePage(ofs));
+  ASSERT_EQ(num_pages - 1, ofs);
+  ASSERT_FALSE(bitmap->AllocatePage(ofs));
 }
 
 TEST(DiskManagerTest, FreePageAllocationTest) {
@@ -56,4 +77,459 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(extent_nums * DiskManager::BITMAP_SIZE - 5, meta_page->GetAllocatedPages());
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
-}
\ No newline at end of file
+}
+
+TEST(DiskManagerTest, BitmapCacheTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const page_id_t num_pages = 2 * DiskManager::BITMAP_SIZE + 10;
+  for (page_id_t i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+
+  // Scenario: a page freed in an earlier extent is reused before the last extent grows.
+  disk_mgr->DeAllocatePage(DiskManager::BITMAP_SIZE + 5);
+  disk_mgr->DeAllocatePage(7);
+  EXPECT_TRUE(disk_mgr->IsPageFree(7));
+  EXPECT_EQ(7, disk_mgr->AllocatePage());
+  EXPECT_EQ(DiskManager::BITMAP_SIZE + 5, disk_mgr->AllocatePage());
+  EXPECT_EQ(num_pages, disk_mgr->AllocatePage());
+  disk_mgr->DeAllocatePage(42);
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: the cached bitmaps are written back on close and read again by the next disk manager.
+  disk_mgr = new DiskManager(db_name, DiskIOBackend::kStream);
+  EXPECT_EQ(num_pages, reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData())->GetAllocatedPages());
+  EXPECT_FALSE(disk_mgr->IsPageFree(7));
+  EXPECT_FALSE(disk_mgr->IsPageFree(num_pages));
+  EXPECT_TRUE(disk_mgr->IsPageFree(42));
+  EXPECT_TRUE(disk_mgr->IsPageFree(num_pages + 1));
+  EXPECT_EQ(42, disk_mgr->AllocatePage());
+  EXPECT_EQ(num_pages + 1, disk_mgr->AllocatePage());
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, AllocatePagesTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  for (page_id_t i = 0; i < 10; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  disk_mgr->DeAllocatePage(3);
+  disk_mgr->DeAllocatePage(4);
+  disk_mgr->DeAllocatePage(7);
+
+  // Scenario: a run goes into the first hole long enough, or after the allocated pages.
+  EXPECT_EQ(3, disk_mgr->AllocatePages(2));
+  EXPECT_EQ(10, disk_mgr->AllocatePages(3));
+  EXPECT_EQ(7, disk_mgr->AllocatePage());
+  EXPECT_EQ(13, disk_mgr->AllocatePage());
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(14, meta_page->GetAllocatedPages());
+  EXPECT_EQ(14, meta_page->GetExtentUsedPage(0));
+
+  // Scenario: a run which does not fit in the rest of an extent starts the next one, a run larger than an extent
+  // cannot be allocated.
+  EXPECT_EQ(DiskManager::BITMAP_SIZE, disk_mgr->AllocatePages(DiskManager::BITMAP_SIZE - 10));
+  EXPECT_EQ(2, meta_page->GetExtentNums());
+  EXPECT_EQ(INVALID_PAGE_ID, disk_mgr->AllocatePages(DiskManager::BITMAP_SIZE + 1));
+  EXPECT_EQ(INVALID_PAGE_ID, disk_mgr->AllocatePages(0));
+  EXPECT_EQ(14, disk_mgr->AllocatePages(5));
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, PreallocationTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const size_t extent_size = (DiskManager::BITMAP_SIZE + 1) * PAGE_SIZE;
+  EXPECT_EQ(PAGE_SIZE, disk_mgr->GetFileUsedSize());
+
+  // Scenario: the first page of an extent reserves room for all of it, the following pages reserve nothing.
+  ASSERT_EQ(0, disk_mgr->AllocatePage());
+  size_t allocated_size = disk_mgr->GetFileAllocatedSize();
+  if (allocated_size == 0) {
+    disk_mgr->Close();
+    delete disk_mgr;
+    remove(db_name.c_str());
+    GTEST_SKIP() << "fallocate is not supported by the file system";
+  }
+  EXPECT_GE(allocated_size, PAGE_SIZE + extent_size);
+  EXPECT_EQ(3 * PAGE_SIZE, disk_mgr->GetFileUsedSize());
+  for (int i = 1; i < 100; i++) {
+    disk_mgr->AllocatePage();
+  }
+  EXPECT_EQ(allocated_size, disk_mgr->GetFileAllocatedSize());
+  EXPECT_EQ(102 * PAGE_SIZE, disk_mgr->GetFileUsedSize());
+
+  // Scenario: a run in a new extent grows the file by one extent.
+  EXPECT_EQ(DiskManager::BITMAP_SIZE, disk_mgr->AllocatePages(DiskManager::BITMAP_SIZE));
+  EXPECT_GE(disk_mgr->GetFileAllocatedSize(), PAGE_SIZE + 2 * extent_size);
+  EXPECT_EQ((103 + DiskManager::BITMAP_SIZE) * PAGE_SIZE, disk_mgr->GetFileUsedSize());
+
+  // Scenario: preallocated pages read as zeros.
+  char buf[PAGE_SIZE];
+  memset(buf, 1, PAGE_SIZE);
+  disk_mgr->ReadPage(50, buf);
+  EXPECT_TRUE(std::all_of(buf, buf + PAGE_SIZE, [](char c) { return c == 0; }));
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, WritePagesTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  DiskManager *disk_mgr = new DiskManager(db_name);
+  // pages 0-3 and 6-7 are adjacent on disk, so are the last page of the first extent and the first page of the second
+  // one is not: a bitmap page lies between them
+  std::vector<page_id_t> page_ids = {7, 2, 0, 3, 6, 1, 12, DiskManager::BITMAP_SIZE - 1, DiskManager::BITMAP_SIZE};
+  std::vector<std::vector<char>> data(page_ids.size(), std::vector<char>(PAGE_SIZE));
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    snprintf(data[i].data(), PAGE_SIZE, "page %d", page_ids[i]);
+    pages.emplace_back(page_ids[i], data[i].data());
+  }
+  EXPECT_EQ(5, disk_mgr->WritePages(pages));
+  EXPECT_EQ(page_ids.size(), disk_mgr->GetNumWrites());
+  char buf[PAGE_SIZE];
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    disk_mgr->ReadPage(page_ids[i], buf);
+    EXPECT_EQ(0, memcmp(buf, data[i].data(), PAGE_SIZE));
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, DirectIOTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name, DiskIOBackend::kPread, true);
+  if (!disk_mgr->IsDirectIO()) {
+    delete disk_mgr;
+    remove(db_name.c_str());
+    GTEST_SKIP() << "O_DIRECT is not supported by the file system";
+  }
+  // Scenario: a buffer pool reads and writes its frames as they are.
+  auto *bpm = new BufferPoolManager(8, disk_mgr);
+  page_id_t page_id;
+  for (int i = 0; i < 16; i++) {
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  for (page_id = 0; page_id < 16; page_id++) {
+    Page *page = bpm->FetchPage(page_id);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    bpm->UnpinPage(page_id, false);
+  }
+  EXPECT_EQ(0, disk_mgr->GetNumBouncedIO());
+  // Scenario: the background writer writes its batches of dirty pages as they are.
+  bpm->StartBackgroundWriter(1.0);
+  for (page_id = 8; page_id < 16; page_id++) {
+    Page *page = bpm->FetchPage(page_id);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d updated", page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  for (int i = 0; i < 100 && bpm->GetWriterStats().bg_pages_written < 8; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(BG_WRITER_INTERVAL_MS));
+  }
+  BufferWriterStats stats = bpm->GetWriterStats();
+  EXPECT_EQ(8, stats.bg_pages_written);
+  EXPECT_LE(stats.bg_writes, stats.bg_pages_written);
+  EXPECT_EQ(0, disk_mgr->GetNumBouncedIO());
+  delete bpm;
+
+  // Scenario: unaligned buffers go through the bounce buffer, alone or in a batch.
+  std::vector<char> unaligned(2 * PAGE_SIZE + 1);
+  char *data = unaligned.data() + (DiskManager::IsAligned(unaligned.data()) ? 1 : 0);
+  snprintf(data, PAGE_SIZE, "unaligned");
+  disk_mgr->WritePage(20, data);
+  std::vector<std::pair<page_id_t, const char *>> pages = {{21, data}, {22, data + PAGE_SIZE}};
+  snprintf(data + PAGE_SIZE, PAGE_SIZE, "unaligned too");
+  EXPECT_EQ(1, disk_mgr->WritePages(pages));
+  EXPECT_EQ(3, disk_mgr->GetNumBouncedIO());
+  memset(data, 0, PAGE_SIZE);
+  disk_mgr->ReadPage(22, data);
+  EXPECT_STREQ("unaligned too", data);
+  EXPECT_EQ(4, disk_mgr->GetNumBouncedIO());
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: the file is the same as with buffered I/O.
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(16, reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData())->GetAllocatedPages());
+  char buf[PAGE_SIZE];
+  disk_mgr->ReadPage(7, buf);
+  EXPECT_STREQ("page 7", buf);
+  disk_mgr->ReadPage(12, buf);
+  EXPECT_STREQ("page 12 updated", buf);
+  disk_mgr->ReadPage(21, buf);
+  EXPECT_STREQ("unaligned", buf);
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, ConcurrentReadTest) {
+  std::string db_name = "disk_test.db";
+  const int num_pages = 256;
+  const int num_threads = 4;
+  for (auto backend : {DiskIOBackend::kStream, DiskIOBackend::kPread}) {
+    remove(db_name.c_str());
+    DiskManager *disk_mgr = new DiskManager(db_name, backend);
+    char buf[PAGE_SIZE];
+    for (int i = 0; i < num_pages; i++) {
+      ASSERT_EQ(i, disk_mgr->AllocatePage());
+      memset(buf, i, PAGE_SIZE);
+      disk_mgr->WritePage(i, buf);
+    }
+    // Scenario: threads reading different pages at the same time each see the content of their own page.
+    std::vector<std::thread> threads;
+    std::atomic<int> mismatches{0};
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        char page[PAGE_SIZE];
+        for (int round = 0; round < 10; round++) {
+          for (int i = t; i < num_pages; i += num_threads) {
+            disk_mgr->ReadPage(i, page);
+            if (page[0] != static_cast<char>(i) || page[PAGE_SIZE - 1] != static_cast<char>(i)) {
+              mismatches++;
+            }
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(0, mismatches);
+    EXPECT_EQ(num_pages * 10, disk_mgr->GetNumReads());
+    disk_mgr->Close();
+    delete disk_mgr;
+
+    // Scenario: both backends share the file format, a file written by one is read back by the other.
+    auto other = backend == DiskIOBackend::kStream ? DiskIOBackend::kPread : DiskIOBackend::kStream;
+    disk_mgr = new DiskManager(db_name, other);
+    EXPECT_EQ(num_pages, reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData())->GetAllocatedPages());
+    EXPECT_FALSE(disk_mgr->IsPageFree(num_pages - 1));
+    disk_mgr->ReadPage(num_pages - 1, buf);
+    EXPECT_EQ(static_cast<char>(num_pages - 1), buf[PAGE_SIZE / 2]);
+    // a page beyond the end of the file reads as zeros
+    disk_mgr->ReadPage(num_pages + 10, buf);
+    EXPECT_EQ(0, buf[0]);
+    disk_mgr->Close();
+    delete disk_mgr;
+  }
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, AsyncIOTest) {
+  std::string db_name = "disk_test.db";
+  const int num_pages = 300;  // more than the io_uring holds at once
+  for (auto backend : {DiskIOBackend::kIoUring, DiskIOBackend::kPread}) {
+    remove(db_name.c_str());
+    DiskManager *disk_mgr = new DiskManager(db_name, backend);
+    std::vector<std::vector<char>> pages(num_pages, std::vector<char>(PAGE_SIZE));
+    for (int i = 0; i < num_pages; i++) {
+      ASSERT_EQ(i, disk_mgr->AllocatePage());
+      snprintf(pages[i].data(), PAGE_SIZE, "page %d", i);
+    }
+
+    // Scenario: every queued write completes once, reported by its tag.
+    std::vector<uint64_t> tags;
+    for (int i = 0; i < num_pages; i++) {
+      disk_mgr->WritePageAsync(i, pages[i].data(), i);
+    }
+    disk_mgr->SubmitAsync();
+    while (disk_mgr->GetNumPendingAsync() > 0) {
+      disk_mgr->ReapAsync(tags);
+    }
+    std::sort(tags.begin(), tags.end());
+    ASSERT_EQ(num_pages, tags.size());
+    for (int i = 0; i < num_pages; i++) {
+      EXPECT_EQ(i, tags[i]);
+    }
+    EXPECT_EQ(num_pages, disk_mgr->GetNumWrites());
+
+    // Scenario: pages read back asynchronously have the content written, a page beyond the file reads as zeros.
+    std::vector<std::vector<char>> read_back(num_pages + 1, std::vector<char>(PAGE_SIZE, 'x'));
+    for (int i = 0; i <= num_pages; i++) {
+      disk_mgr->ReadPageAsync(i == num_pages ? num_pages + 100 : i, read_back[i].data(), i);
+    }
+    tags.clear();
+    disk_mgr->ReapAsync(tags, num_pages + 1);
+    EXPECT_EQ(num_pages + 1, tags.size());
+    EXPECT_EQ(0, disk_mgr->GetNumPendingAsync());
+    for (int i = 0; i < num_pages; i++) {
+      EXPECT_EQ(pages[i], read_back[i]);
+    }
+    EXPECT_EQ(std::vector<char>(PAGE_SIZE, 0), read_back[num_pages]);
+
+    // Scenario: requests still in flight are finished when the disk manager is closed.
+    for (int i = 0; i < num_pages; i++) {
+      disk_mgr->WritePageAsync(i, pages[num_pages - 1 - i].data(), i);
+    }
+    disk_mgr->Close();
+    delete disk_mgr;
+    disk_mgr = new DiskManager(db_name, backend);
+    char buf[PAGE_SIZE];
+    disk_mgr->ReadPage(0, buf);
+    EXPECT_EQ(0, memcmp(buf, pages[num_pages - 1].data(), PAGE_SIZE));
+    disk_mgr->Close();
+    delete disk_mgr;
+  }
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, PageCodecTest) {
+  std::mt19937 rng(0);
+  std::vector<char> text(PAGE_SIZE);
+  for (int i = 0; i < PAGE_SIZE; i++) {
+    text[i] = static_cast<char>("name_"[i % 5] + i / 300);
+  }
+  std::vector<char> noise(PAGE_SIZE);
+  for (auto &c : noise) {
+    c = static_cast<char>(rng());
+  }
+  std::vector<char> compressed(2 * PAGE_SIZE);
+  std::vector<char> page(PAGE_SIZE);
+
+  // Scenario: repetitive pages shrink a lot and decompress to what they were.
+  for (auto &data : {std::vector<char>(PAGE_SIZE, 0), text}) {
+    size_t length = PageCodec::Compress(data.data(), PAGE_SIZE, compressed.data(), PAGE_SIZE);
+    ASSERT_GT(length, 0);
+    EXPECT_LT(length, PAGE_SIZE / 8);
+    ASSERT_TRUE(PageCodec::Decompress(compressed.data(), length, page.data(), PAGE_SIZE));
+    EXPECT_EQ(data, page);
+    // a truncated input or an output of the wrong size is rejected
+    EXPECT_FALSE(PageCodec::Decompress(compressed.data(), length - 1, page.data(), PAGE_SIZE));
+    EXPECT_FALSE(PageCodec::Decompress(compressed.data(), length, page.data(), PAGE_SIZE - 1));
+  }
+
+  // Scenario: random bytes do not fit in less than a page, but still round trip given room.
+  EXPECT_EQ(0, PageCodec::Compress(noise.data(), PAGE_SIZE, compressed.data(), PAGE_SIZE));
+  size_t length = PageCodec::Compress(noise.data(), PAGE_SIZE, compressed.data(), compressed.size());
+  ASSERT_GT(length, PAGE_SIZE);
+  ASSERT_TRUE(PageCodec::Decompress(compressed.data(), length, page.data(), PAGE_SIZE));
+  EXPECT_EQ(noise, page);
+}
+
+TEST(DiskManagerTest, CompressionTest) {
+  std::string db_name = "disk_test.db";
+  const int num_pages = 100;
+  remove(db_name.c_str());
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(PAGE_SIZE));
+  std::mt19937 rng(0);
+  for (int i = 0; i < num_pages; i++) {
+    // wide CHAR columns padded with zeros, every tenth page random
+    for (int j = 0; j < PAGE_SIZE; j++) {
+      pages[i][j] = i % 10 == 9 ? static_cast<char>(rng()) : j % 64 < 20 ? static_cast<char>('a' + (i + j) % 26) : 0;
+    }
+  }
+  auto *disk_mgr = new DiskManager(db_name, DiskIOBackend::kPread, false, true);
+  ASSERT_TRUE(disk_mgr->IsCompressed());
+  for (int i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+    disk_mgr->WritePage(i, pages[i].data());
+  }
+
+  // Scenario: compressible pages take a few sectors, the others are stored as they are.
+  DiskCompressionStats stats = disk_mgr->GetCompressionStats();
+  EXPECT_EQ(90, stats.pages_compressed);
+  EXPECT_EQ(10, stats.pages_stored_raw);
+  EXPECT_EQ(num_pages * PAGE_SIZE, stats.bytes_in);
+  EXPECT_GT(stats.Ratio(), 2);
+  char buf[PAGE_SIZE];
+  for (int i = 0; i < num_pages; i++) {
+    disk_mgr->ReadPage(i, buf);
+    ASSERT_EQ(0, memcmp(buf, pages[i].data(), PAGE_SIZE));
+  }
+  EXPECT_EQ(90, disk_mgr->GetCompressionStats().pages_decompressed);
+  EXPECT_EQ(stats.bytes_out, disk_mgr->GetCompressionStats().bytes_read);
+
+  // Scenario: a page rewritten with a larger slot is read whole although the page map is stale.
+  std::vector<char> noise(PAGE_SIZE);
+  for (auto &c : noise) {
+    c = static_cast<char>(rng());
+  }
+  disk_mgr->WritePage(0, noise.data());
+  disk_mgr->WritePage(1, pages[0].data());
+  disk_mgr->WritePage(1, noise.data());
+  disk_mgr->WritePage(0, pages[0].data());
+  disk_mgr->ReadPage(1, buf);
+  EXPECT_EQ(0, memcmp(buf, noise.data(), PAGE_SIZE));
+  disk_mgr->WritePage(1, pages[1].data());
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: the file stays compressed when it is opened without asking for it, and the saved page map makes reads
+  // fetch only the slots.
+  for (auto backend : {DiskIOBackend::kPread, DiskIOBackend::kIoUring, DiskIOBackend::kStream}) {
+    disk_mgr = new DiskManager(db_name, backend);
+    EXPECT_TRUE(disk_mgr->IsCompressed());
+    std::vector<std::vector<char>> read_back(num_pages, std::vector<char>(PAGE_SIZE));
+    for (int i = 0; i < num_pages; i++) {
+      disk_mgr->ReadPageAsync(i, read_back[i].data(), i);
+    }
+    std::vector<uint64_t> tags;
+    disk_mgr->ReapAsync(tags, num_pages);
+    ASSERT_EQ(num_pages, tags.size());
+    EXPECT_EQ(pages, read_back);
+    if (backend != DiskIOBackend::kStream) {
+      EXPECT_EQ(stats.bytes_out, disk_mgr->GetCompressionStats().bytes_read);
+    }
+    // through the page cache the kernel reads the whole cache pages a slot spans, all of a page unless it is larger
+    // than a cache page
+    DiskCompressionStats read_stats = disk_mgr->GetCompressionStats();
+    EXPECT_LE(read_stats.bytes_read, read_stats.device_bytes_read);
+    EXPECT_LE(read_stats.device_bytes_read, num_pages * PAGE_SIZE);
+    if (PAGE_SIZE == sysconf(_SC_PAGESIZE)) {
+      EXPECT_EQ(num_pages * PAGE_SIZE, read_stats.device_bytes_read);
+    }
+    disk_mgr->Close();
+    delete disk_mgr;
+  }
+
+  // Scenario: with direct I/O, slots are written and read back alone, and the device only transfers their sectors.
+  disk_mgr = new DiskManager(db_name, DiskIOBackend::kPread, true);
+  if (disk_mgr->IsDirectIO()) {
+    for (int i = 0; i < num_pages; i++) {
+      disk_mgr->WritePage(i, pages[num_pages - 1 - i].data());
+    }
+    for (int i = 0; i < num_pages; i++) {
+      disk_mgr->ReadPage(i, buf);
+      ASSERT_EQ(0, memcmp(buf, pages[num_pages - 1 - i].data(), PAGE_SIZE));
+    }
+    DiskCompressionStats direct_stats = disk_mgr->GetCompressionStats();
+    EXPECT_EQ(direct_stats.bytes_read, direct_stats.device_bytes_read);
+    EXPECT_LT(direct_stats.device_bytes_read, num_pages * PAGE_SIZE / 2);
+    for (int i = 0; i < num_pages; i++) {
+      disk_mgr->WritePage(i, pages[i].data());
+    }
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: pages used in place from a mapping are decompressed once.
+  disk_mgr = new DiskManager(db_name, DiskIOBackend::kMmap);
+  for (int i = 0; i < num_pages; i++) {
+    const char *data = disk_mgr->MapPage(i);
+    ASSERT_NE(nullptr, data);
+    EXPECT_EQ(0, memcmp(data, pages[i].data(), PAGE_SIZE));
+    EXPECT_EQ(data, disk_mgr->MapPage(i));
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+  remove((db_name + ".slots").c_str());
+}
@@ -0,0 +1,96 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk_manager.h"
+
+/**
+ * Drop the pages of the db file from the OS page cache, so that reads go to the device.
+ */
+static void DropPageCache(const std::string &db_name) {
+  int fd = open(db_name.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+}
+
+/**
+ * Random page reads from a single thread at increasing queue depths, in the manner of
+ * fio --rw=randread --bs=4k --ioengine=io_uring --iodepth=N. The first row is the synchronous pread backend, which
+ * always runs at queue depth 1.
+ */
+TEST(IoUringBenchmark, QueueDepthScaling) {
+  const std::string db_name = "io_uring_benchmark.db";
+  const int num_pages = 32768;
+  const size_t num_reads = 20000;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name, DiskIOBackend::kIoUring);
+  if (!disk_manager->IsAsyncIOSupported()) {
+    printf("io_uring is not available, the asynchronous rows run synchronously\n");
+  }
+  std::vector<char> data(PAGE_SIZE);
+  for (int i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_manager->AllocatePage());
+    memset(data.data(), i, PAGE_SIZE);
+    disk_manager->WritePage(i, data.data());
+  }
+  disk_manager->Close();
+  delete disk_manager;
+
+  std::mt19937 rng(42);
+  std::vector<page_id_t> page_ids(num_reads);
+  for (auto &page_id : page_ids) {
+    page_id = rng() % num_pages;
+  }
+
+  printf("%-10s %6s %12s %14s\n", "engine", "depth", "IOPS", "avg lat (us)");
+  {
+    DropPageCache(db_name);
+    DiskManager sync_manager(db_name, DiskIOBackend::kPread);
+    auto start = std::chrono::steady_clock::now();
+    for (auto page_id : page_ids) {
+      sync_manager.ReadPage(page_id, data.data());
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    printf("%-10s %6d %12.0f %14.1f\n", "pread", 1, num_reads / elapsed.count(), elapsed.count() * 1e6 / num_reads);
+  }
+
+  for (size_t depth : {1, 2, 4, 8, 16, 32, 64}) {
+    DropPageCache(db_name);
+    DiskManager async_manager(db_name, DiskIOBackend::kIoUring);
+    std::vector<std::vector<char>> buffers(depth, std::vector<char>(PAGE_SIZE));
+    std::vector<uint64_t> free_buffers;
+    for (size_t i = 0; i < depth; i++) {
+      free_buffers.push_back(i);
+    }
+    std::vector<uint64_t> done;
+    size_t next = 0;
+    size_t completed = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (completed < num_reads) {
+      // keep depth reads in flight, refilling the queue as reads complete
+      while (next < num_reads && !free_buffers.empty()) {
+        uint64_t buffer = free_buffers.back();
+        free_buffers.pop_back();
+        async_manager.ReadPageAsync(page_ids[next++], buffers[buffer].data(), buffer);
+      }
+      async_manager.SubmitAsync();
+      done.clear();
+      completed += async_manager.ReapAsync(done);
+      free_buffers.insert(free_buffers.end(), done.begin(), done.end());
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    printf("%-10s %6zu %12.0f %14.1f\n", "io_uring", depth, num_reads / elapsed.count(),
+           elapsed.count() * 1e6 * depth / num_reads);
+  }
+  remove(db_name.c_str());
+}
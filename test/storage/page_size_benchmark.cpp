@@ -0,0 +1,108 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/page_access_trace.h"
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/comparator.h"
+#include "storage/table_heap.h"
+
+static double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Measure scan and point-lookup throughput of a table with a B+ tree index on its key, at the page size of this
+ * build. The buffer pool holds the same number of bytes whatever the page size, less than the table, so that scans
+ * read from the db file. Build and run it at every page size with "make page_size_benchmarks".
+ */
+static void RunScanAndLookup(const std::string &db_name) {
+  const size_t pool_bytes = 8 * 1024 * 1024;
+  const int row_nums = 100000;
+  const int lookups = 100000;
+  DBStorageEngine engine(db_name, true, DEFAULT_BUFFER_POOL_SIZE, 1);
+  BufferPoolManager *bpm = engine.bpm_;
+
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 100, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::unique_ptr<TableHeap> table_heap(TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr));
+  std::vector<Column *> key_columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  auto key_schema = std::make_shared<Schema>(key_columns);
+  KeyManager KP(key_schema.get(), 16);
+  BPlusTree tree(0, bpm, KP);
+  GenericKey *key = KP.InitKey();
+  char name[100];
+  memset(name, 'x', sizeof(name));
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, sizeof(name), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+    KP.SerializeFromKey(key, Row(key_fields), key_schema.get());
+    ASSERT_TRUE(tree.Insert(key, row.GetRowId(), nullptr));
+  }
+  double load_seconds = SecondsSince(start);
+  // 插入时表堆从第一页找空闲空间，在大缓冲池中装载，测量前再缩小
+  ASSERT_TRUE(bpm->Resize(pool_bytes / PAGE_SIZE));
+
+  // 一次查找经过的索引页数即树高
+  std::vector<Field> probe_fields{Field(TypeId::kTypeInt, row_nums / 2)};
+  KP.SerializeFromKey(key, Row(probe_fields), key_schema.get());
+  std::vector<RowId> result;
+  PageAccessTrace trace;
+  bpm->SetAccessTrace(&trace);
+  tree.GetValue(key, result, nullptr);
+  bpm->SetAccessTrace(nullptr);
+  size_t tree_height = trace.GetPageIds().size();
+
+  const int scans = 3;
+  size_t scanned = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < scans; i++) {
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+      scanned++;
+    }
+  }
+  double scan_seconds = SecondsSince(start);
+  EXPECT_EQ(scans * row_nums, scanned);
+
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int> any(0, row_nums - 1);
+  size_t found = 0;
+  size_t tree_found = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, any(rng))};
+    KP.SerializeFromKey(key, Row(fields), key_schema.get());
+    result.clear();
+    if (tree.GetValue(key, result, nullptr)) {
+      tree_found++;
+      Row row(result[0]);
+      found += table_heap->GetTuple(&row, nullptr) ? 1 : 0;
+    }
+  }
+  double lookup_seconds = SecondsSince(start);
+  EXPECT_EQ(lookups, tree_found);
+  EXPECT_EQ(lookups, found);
+  free(key);
+
+  printf("%-10s %8s %12s %14s %14s %12s\n", "page size", "frames", "tree height", "load rows/s", "scan rows/s",
+         "lookups/s");
+  printf("%-10d %8zu %12zu %14.0f %14.0f %12.0f\n", PAGE_SIZE, bpm->GetPoolSize(), tree_height,
+         row_nums / load_seconds, scanned / scan_seconds, lookups / lookup_seconds);
+}
+
+TEST(PageSizeBenchmark, ScanAndLookup) {
+  const std::string db_name = "page_size_benchmark.db";
+  RunScanAndLookup(db_name);
+  remove(("./databases/" + db_name).c_str());
+  remove(("./databases/" + db_name + ".warm").c_str());
+}
@@ -36,6 +36,12 @@ TEST(TableHeapTest, TableHeapSampleTest) {
                    Field(TypeId::kTypeFloat, RandomUtils::RandomFloat(-999.f, 999.f))};
     Row row(*fields);
     ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    if (i % 100 == 0) {
+      // 其他页（例如索引页）和堆交错分配
+      page_id_t other_page_id;
+      ASSERT_NE(nullptr, bpm_->NewPage(other_page_id));
+      bpm_->UnpinPage(other_page_id, false);
+    }
     if (row_values.find(row.GetRowId().Get()) != row_values.end()) {
       std::cout << row.GetRowId().Get() << std::endl;
       ASSERT_TRUE(false);
@@ -60,4 +66,69 @@ TEST(TableHeapTest, TableHeapSampleTest) {
     delete row_kv.second;
   }
   ASSERT_EQ(size, 0);
+
+  // Scenario: the heap grew by runs of pages with consecutive ids despite the pages allocated in between, and no page
+  // was left pinned.
+  size_t num_pages = 0, num_consecutive = 0;
+  for (page_id_t page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<TablePage *>(bpm_->FetchPage(page_id));
+    ASSERT_NE(nullptr, page);
+    page_id_t next_page_id = page->GetNextPageId();
+    bpm_->UnpinPage(page_id, false);
+    num_pages++;
+    num_consecutive += next_page_id == page_id + 1;
+    page_id = next_page_id;
+  }
+  EXPECT_GT(num_pages, TABLE_HEAP_GROWTH_PAGES);
+  EXPECT_GE(num_consecutive, num_pages * (TABLE_HEAP_GROWTH_PAGES - 1) / TABLE_HEAP_GROWTH_PAGES - 1);
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+}
+
+TEST(TableHeapTest, ReadOnlyTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr_ = new DiskManager(db_file_name);
+  auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  const int row_nums = 100;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("account", TypeId::kTypeFloat, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr);
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeFloat, 1.5f * i)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  page_id_t first_page_id = table_heap->GetFirstPageId();
+  delete table_heap;
+  delete bpm_;
+  disk_mgr_->Close();
+  delete disk_mgr_;
+
+  disk_mgr_ = new DiskManager(db_file_name, DiskIOBackend::kMmap);
+  bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  table_heap = TableHeap::Create(bpm_, first_page_id, schema.get(), nullptr, nullptr);
+
+  // Scenario: the pages are mapped read-only, every change is refused before it touches a page.
+  Fields fields{Field(TypeId::kTypeInt, row_nums), Field(TypeId::kTypeFloat, 0.f)};
+  Row row(fields);
+  EXPECT_FALSE(table_heap->InsertTuple(row, nullptr));
+  EXPECT_FALSE(table_heap->UpdateTuple(row, rids[0], nullptr));
+  EXPECT_FALSE(table_heap->MarkDelete(rids[1], nullptr));
+  table_heap->ApplyDelete(rids[2], nullptr);
+  table_heap->RollbackDelete(rids[3], nullptr);
+  EXPECT_TRUE(bpm_->CheckAllUnpinned());
+
+  // Scenario: every row can still be read as it was written.
+  for (int i = 0; i < row_nums; i++) {
+    Row read_row(rids[i]);
+    ASSERT_TRUE(table_heap->GetTuple(&read_row, nullptr));
+    EXPECT_EQ(CmpBool::kTrue, read_row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+  }
+  delete table_heap;
+  delete bpm_;
+  disk_mgr_->Close();
+  delete disk_mgr_;
+  remove(db_file_name.c_str());
 }